@@ -0,0 +1,213 @@
+/*******************************************************************************
+ * Name            : scan_bench.cc
+ * Description     : Measures the throughput of Scanner::Scan on synthetic
+ *                   FCAL corpora of 1KB to 100MB, reporting MB/s and
+ *                   tokens/s with their spread over repeated runs. Build
+ *                   and run with "make scan_bench"; an optional argument
+ *                   caps the corpus size in bytes.
+ ******************************************************************************/
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "include/scanner.h"
+#include "include/symbol_table.h"
+#include "include/token_stream.h"
+
+/*******************************************************************************
+ * Constant Definitions
+ ******************************************************************************/
+/// Corpus sizes, from 1KB to 100MB.
+static const size_t kSizes[] = {
+  1024, 10 * 1024, 100 * 1024, 1024 * 1024, 10 * 1024 * 1024,
+  100 * 1024 * 1024
+};
+
+/// Each sample scans the corpus enough times to cover at least this many
+/// bytes, so that the timings of small corpora are not lost in the
+/// resolution of the clock.
+static const size_t kSampleBytes = 4 * 1024 * 1024;
+
+/// Samples taken of each corpus; the largest ones take fewer.
+static const int kSamples = 10;
+static const int kLargeSamples = 3;
+static const size_t kLargeCorpus = 10 * 1024 * 1024;
+
+/*******************************************************************************
+ * Helper Functions
+ ******************************************************************************/
+/// A small deterministic generator, so every run scans the same text.
+class Random {
+ public:
+  explicit Random(unsigned seed) : state_(seed) {}
+  unsigned Next(unsigned bound) {
+    state_ = state_ * 1103515245u + 12345u;
+    return (state_ >> 8) % bound;
+  }
+
+ private:
+  unsigned state_;
+};
+
+static const char *Pick(Random *random, const char *const *words, int count) {
+  return words[random->Next(count)];
+}
+
+/// Keywords with just enough punctuation between them.
+static void AddKeywordLine(Random *random, std::string *text) {
+  static const char *const kKeywords[] = {
+    "int", "float", "boolean", "True", "False", "string", "matrix", "let",
+    "in", "end", "if", "then", "else", "repeat", "while", "print", "to"
+  };
+  for (int i = 0; i < 8; i++) {
+    *text += Pick(random, kKeywords, 17);
+    *text += i % 3 == 2 ? " ;\n" : " ";
+  }
+}
+
+/// Assignments between long variable names.
+static void AddIdentifierLine(Random *random, std::string *text) {
+  static const char *const kStems[] = {
+    "cell", "forest_cover", "loss_rate", "row", "column", "total_area",
+    "threshold", "neighbour_count"
+  };
+  static const char *const kOperators[] = { " + ", " * ", " - ", " / " };
+  for (int i = 0; i < 4; i++) {
+    if (i > 0) *text += i == 1 ? " = " : Pick(random, kOperators, 4);
+    *text += Pick(random, kStems, 8);
+    *text += "_" + std::to_string(random->Next(1000));
+  }
+  *text += " ;\n";
+}
+
+/// Mostly block and line comments, with a statement now and then.
+static void AddCommentLine(Random *random, std::string *text) {
+  switch (random->Next(3)) {
+    case 0:
+      *text += "/* update the running total of the cells in this row,"
+               " skipping the\n   ones outside the study area */\n";
+      break;
+    case 1:
+      *text += "// the loss rate is a fraction of the area, not a percentage\n";
+      break;
+    default:
+      *text += "x = x + 1 ;   // keep going\n";
+      break;
+  }
+}
+
+/// print statements of long string constants.
+static void AddStringLine(Random *random, std::string *text) {
+  *text += "print \"";
+  int length = 100 + random->Next(200);
+  for (int i = 0; i < length; i++) {
+    *text += static_cast<char>('a' + random->Next(26));
+    if (i % 12 == 11) *text += ' ';
+  }
+  *text += "\" ;\n";
+}
+
+typedef void (*LineFunction)(Random *, std::string *);
+
+struct Corpus {
+  const char *name;
+  LineFunction add_line;
+};
+
+static const Corpus kCorpora[] = {
+  { "keywords", AddKeywordLine },
+  { "identifiers", AddIdentifierLine },
+  { "comments", AddCommentLine },
+  { "strings", AddStringLine }
+};
+
+/// Lines from add_line until the text is bytes long.
+static std::string MakeCorpus(LineFunction add_line, size_t bytes) {
+  Random random(2016);
+  std::string text;
+  text.reserve(bytes + 512);
+  while (text.size() < bytes) add_line(&random, &text);
+  text.resize(bytes);
+  // Do not leave half a token or comment at the end.
+  size_t last_line = text.rfind('\n');
+  if (last_line != std::string::npos) text.resize(last_line + 1);
+  return text;
+} /* MakeCorpus() */
+
+/// The mean and standard deviation of samples.
+static void MeanAndDeviation(const std::vector<double> &samples,
+                             double *mean, double *deviation) {
+  double sum = 0.0;
+  for (size_t i = 0; i < samples.size(); i++) sum += samples[i];
+  *mean = sum / samples.size();
+  double squares = 0.0;
+  for (size_t i = 0; i < samples.size(); i++) {
+    squares += (samples[i] - *mean) * (samples[i] - *mean);
+  }
+  *deviation = samples.size() > 1 ? sqrt(squares / (samples.size() - 1)) : 0;
+} /* MeanAndDeviation() */
+
+/*!
+ * Measure() - Scan text repeatedly and print the throughput. Variable
+ * names are interned into a symbol table, as they are when parsing.
+ */
+static void Measure(const char *name, const std::string &text) {
+  fcal::scanner::Scanner scanner;
+  fcal::scanner::SymbolTable symbols;
+  fcal::scanner::TokenStream tokens;
+  tokens.symbol_table(&symbols);
+
+  int scans = static_cast<int>(kSampleBytes / text.size());
+  if (scans < 1) scans = 1;
+  int samples = text.size() >= kLargeCorpus ? kLargeSamples : kSamples;
+
+  // One scan first, so the stream and symbol table have grown to size.
+  scanner.Scan(text.c_str(), &tokens);
+  int token_count = tokens.size();
+
+  std::vector<double> megabytes_per_second;
+  std::vector<double> tokens_per_second;
+  for (int i = 0; i < samples; i++) {
+    std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+    for (int j = 0; j < scans; j++) scanner.Scan(text.c_str(), &tokens);
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    double seconds = elapsed.count() / scans;
+    megabytes_per_second.push_back(text.size() / (1024.0 * 1024.0) /
+                                   seconds);
+    tokens_per_second.push_back(token_count / seconds);
+  }
+
+  double mb_mean, mb_deviation, tokens_mean, tokens_deviation;
+  MeanAndDeviation(megabytes_per_second, &mb_mean, &mb_deviation);
+  MeanAndDeviation(tokens_per_second, &tokens_mean, &tokens_deviation);
+  printf("%-12s %10d %10d %9.1f +- %-7.1f %8.2f +- %-6.2f\n", name,
+         static_cast<int>(text.size()), token_count, mb_mean, mb_deviation,
+         tokens_mean / 1e6, tokens_deviation / 1e6);
+  fflush(stdout);
+} /* Measure() */
+
+/*******************************************************************************
+ * Functions
+ ******************************************************************************/
+int main(int argc, char **argv) {
+  size_t max_bytes = argc > 1 ? strtoul(argv[1], nullptr, 10) : 0;
+
+  printf("%-12s %10s %10s %20s %20s\n", "corpus", "bytes", "tokens",
+         "MB/s", "Mtokens/s");
+  for (unsigned c = 0; c < sizeof(kCorpora) / sizeof(kCorpora[0]); c++) {
+    for (unsigned s = 0; s < sizeof(kSizes) / sizeof(kSizes[0]); s++) {
+      if (max_bytes > 0 && kSizes[s] > max_bytes) break;
+      std::string text = MakeCorpus(kCorpora[c].add_line, kSizes[s]);
+      Measure(kCorpora[c].name, text);
+    }
+  }
+  return EXIT_SUCCESS;
+} /* main() */
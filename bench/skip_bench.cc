@@ -0,0 +1,122 @@
+/*******************************************************************************
+ * Name            : skip_bench.cc
+ * Description     : Compares the regex based white space and comment skipper
+ *                   with SkipWhitespaceAndComments on indented, commented
+ *                   FCAL text. Build and run with "make skip_bench".
+ ******************************************************************************/
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <string>
+#include "include/lexer.h"
+#include "include/scanner.h"
+#include "include/whitespace.h"
+
+/*******************************************************************************
+ * Constant Definitions
+ ******************************************************************************/
+/// Size of the generated program. regexec looks at the whole remaining
+/// text on every call, so the regex side is quadratic and this is kept
+/// small enough for it to finish.
+static const size_t kCorpusBytes = 256 * 1024;
+
+/// Each timing is the best of this many runs.
+static const int kRepetitions = 5;
+
+/*******************************************************************************
+ * Helper Functions
+ ******************************************************************************/
+/*!
+ * MakeCorpus() - Build a program in the style of our generated FCAL:
+ * deeply indented statements, each preceded by a block comment and
+ * followed by a line comment.
+ */
+static std::string MakeCorpus(size_t bytes) {
+  std::string text;
+  int depth = 0;
+  for (int line = 0; text.size() < bytes; ++line) {
+    std::string indent(4 * (1 + depth), ' ');
+    text += indent + "/* step " + std::to_string(line) +
+            ": update the running total for this cell */\n";
+    text += indent + "total = total + cell_" + std::to_string(line % 97) +
+            " * 2 ;   // keep the total in range\n";
+    if (line % 8 == 0) {
+      text += indent + "\t\r\n\n";
+    }
+    depth = (depth + 1) % 6;
+  }
+  return text;
+} /* MakeCorpus() */
+
+typedef int (*SkipFunction)(const char *);
+
+/*!
+ * Walk() - Step through text the way the scanner does, alternating the
+ * skipper with MatchToken, and return the number of tokens seen.
+ */
+static int Walk(const char *text, SkipFunction skip) {
+  int tokens = 0;
+  const char *p = text;
+  for (;;) {
+    p += skip(p);
+    fcal::scanner::TokenType terminal;
+    int length = fcal::scanner::MatchToken(p, &terminal);
+    if (terminal == fcal::scanner::kEndOfFile) break;
+    p += length > 0 ? length : 1;
+    ++tokens;
+  }
+  return tokens;
+} /* Walk() */
+
+/*!
+ * BestSeconds() - Time kRepetitions walks over text and return the
+ * fastest, storing the token count in tokens.
+ */
+static double BestSeconds(const char *text, SkipFunction skip, int *tokens) {
+  double best = 0.0;
+  for (int i = 0; i < kRepetitions; ++i) {
+    std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+    *tokens = Walk(text, skip);
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    if (i == 0 || elapsed.count() < best) best = elapsed.count();
+  }
+  return best;
+} /* BestSeconds() */
+
+static int RegexSkip(const char *text) {
+  return fcal::scanner::consume_whitespace_and_comments(text);
+}
+
+/*******************************************************************************
+ * Functions
+ ******************************************************************************/
+int main(void) {
+  std::string corpus = MakeCorpus(kCorpusBytes);
+  double megabytes = corpus.size() / (1024.0 * 1024.0);
+
+  int regex_tokens = 0;
+  int fast_tokens = 0;
+  double regex_seconds = BestSeconds(corpus.c_str(), RegexSkip,
+                                     &regex_tokens);
+  double fast_seconds = BestSeconds(corpus.c_str(),
+                                    fcal::scanner::SkipWhitespaceAndComments,
+                                    &fast_tokens);
+  if (regex_tokens != fast_tokens) {
+    fprintf(stderr, "token counts differ: %d vs %d\n", regex_tokens,
+            fast_tokens);
+    return EXIT_FAILURE;
+  }
+
+  printf("corpus: %d bytes, %d tokens\n", static_cast<int>(corpus.size()),
+         fast_tokens);
+  printf("regex skipper:     %8.1f MB/s\n", megabytes / regex_seconds);
+  printf("SkipWhitespace...: %8.1f MB/s\n", megabytes / fast_seconds);
+  printf("speedup:           %8.1fx\n", regex_seconds / fast_seconds);
+  return EXIT_SUCCESS;
+} /* main() */
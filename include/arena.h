@@ -0,0 +1,96 @@
+#ifndef PROJECT_INCLUDE_ARENA_H_
+#define PROJECT_INCLUDE_ARENA_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <stddef.h>
+#include <new>
+#include <utility>
+#include <vector>
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+namespace fcal {
+namespace parser {
+
+/*******************************************************************************
+ * Class Declarations
+ ******************************************************************************/
+/*!
+ * \brief A bump allocator for the objects of one parse.
+ *
+ * Memory is handed out from large blocks by moving a pointer, and is
+ * only given back all at once, when the arena is reset or destroyed.
+ * Destructors of the objects made in an arena are never run, so they
+ * must not own anything outside it: AST nodes point at other nodes and
+ * at strings in the same arena, or at static spellings.
+ */
+class Arena {
+ public:
+  Arena(void) : blocks_(), next_(nullptr), end_(nullptr),
+                block_bytes_(kFirstBlockBytes), first_block_bytes_(0),
+                used_(0) {}
+  ~Arena(void);
+
+  /// Room for bytes, aligned for any type.
+  void *Allocate(size_t bytes) {
+    bytes = (bytes + kAlignment - 1) & ~(kAlignment - 1);
+    if (static_cast<size_t>(end_ - next_) < bytes) AddBlock(bytes);
+    void *p = next_;
+    next_ += bytes;
+    used_ += bytes;
+    return p;
+  }
+
+  /// Construct a T in the arena.
+  template <class T, class... Args>
+  T *New(Args &&... args) {
+    return new (Allocate(sizeof(T))) T(std::forward<Args>(args)...);
+  }
+
+  /// A copy of the count items at items, which must need no
+  /// constructor or destructor.
+  template <class T>
+  T *CopyArray(const T *items, size_t count) {
+    T *copy = static_cast<T *>(Allocate(sizeof(T) * count));
+    for (size_t i = 0; i < count; i++) copy[i] = items[i];
+    return copy;
+  }
+
+  /// A null terminated copy of the length characters at text.
+  const char *CopyString(const char *text, int length);
+
+  /// The bytes allocated since the arena was made or last reset.
+  size_t used(void) const { return used_; }
+
+  /// Free everything allocated so far. The first block is kept for the
+  /// next round of allocations.
+  void Reset(void);
+
+ private:
+  Arena(const Arena &);
+  Arena &operator=(const Arena &);
+
+  void AddBlock(size_t bytes);
+
+  static const size_t kAlignment = 16;
+  static const size_t kFirstBlockBytes = 16 * 1024;
+  static const size_t kMaxBlockBytes = 1024 * 1024;
+
+  // blocks_ holds every block; next_ and end_ bound the free space of
+  // the last. Blocks double in size up to kMaxBlockBytes. used_ counts
+  // the bytes handed out.
+  std::vector<char *> blocks_;
+  char *next_;
+  char *end_;
+  size_t block_bytes_;
+  size_t first_block_bytes_;
+  size_t used_;
+}; /* class Arena */
+
+} /* namespace parser */
+} /* namespace fcal */
+
+#endif  // PROJECT_INCLUDE_ARENA_H_
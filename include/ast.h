@@ -7,6 +7,7 @@
 #include <iostream>
 #include <string>
 #include "include/scanner.h"
+#include "include/symbol_table.h"
 
 /*******************************************************************************
  * Namespaces
@@ -22,17 +23,9 @@ class Stmt;
 class Expr;
 class Decl;
 class VarName;
-
-
-/// Template that uses dynamic cast to check the node type
-template <class T, class E>
-T* CastCheck(T* type, E* obj, std::string location) {
-    if (obj) {
-        type = dynamic_cast <T*>(obj);
-        if (!type) { throw (std::string("Cast error in " + location));}
-    }
-    return type;
-}
+class BinOpExpr;
+class StmtsStmt;
+class AstWriter;
 
 /*******************************************************************************
  * Class Definitions
@@ -41,11 +34,18 @@ T* CastCheck(T* type, E* obj, std::string location) {
 /*! 
  * The Node class that acts as the 
  * parent class for all non-terminals
+ *
+ * The parser makes every node, and the strings they point at, in the
+ * Arena of the ParseResult, which frees them all together. Nodes are
+ * never deleted one at a time, so they have no destructors of their
+ * own to run.
  */
 class Node {
  public:
   virtual std::string unparse(void) = 0;
   virtual std::string CppCode(void) = 0;
+  /// Save the node and its children; see AstWriter in ast_serial.h.
+  virtual void Save(AstWriter *out) = 0;
   virtual ~Node(void) {}
 };
 
@@ -56,14 +56,20 @@ class Node {
  */
 class Root : public Node {
  public:
-  Root(VarName *varName, Stmts *stmts) :
-           varName_(varName), stmts_(stmts) {}
+  Root(VarName *varName, Stmts *stmts, int body) :
+           varName_(varName), stmts_(stmts), body_(body) {}
   std::string unparse();
   std::string CppCode();
-  ~Root();
+  void Save(AstWriter *out);
+  VarName *varName() const { return varName_; }
+  Stmts *stmts() const { return stmts_; }
+  /// The offset just past the '{' that opens the body of the program,
+  /// from which the offsets in its block of statements are kept.
+  int body() const { return body_; }
  private:
   VarName *varName_;
   Stmts *stmts_;
+  int body_;
 };
 
 /*!
@@ -76,37 +82,39 @@ class Stmts : public Node {
  public:
   virtual std::string unparse(void) = 0;
   virtual std::string CppCode(void) = 0;
+  virtual void Save(AstWriter *out) = 0;
   virtual ~Stmts() {}
 };
 
 /*!
- * Concrete class for empty statements
- * production : Stmts ::= <<empty>>
- */
-class EmptyStmts : public Stmts {
- public:
-  EmptyStmts() {}
-  std::string unparse();
-  std::string CppCode();
-  ~EmptyStmts() {}
-};
-
-/*!
- * Concrete class for a statment sequence
- * production : Stmts ::= Stmt Stmts
+ * Concrete class for a block of statements
+ * production : Stmts ::= Stmt Stmts | <<empty>>
+ * The statements of a block are kept in one array, in order, rather
+ * than as a chain of nodes, so a block of any length is parsed,
+ * unparsed and translated without recursing once per statement.
+ *
+ * starts[i] is where the first token of statement i begins, and
+ * starts[count] where the token closing the block begins. They are
+ * offsets from the end of the token that opened the block, so a block
+ * reused by Parser::Reparse stays right when text before it changes.
  */
-class StmtsSeq : public Stmts {
+class StmtsBlock : public Stmts {
  public:
-  StmtsSeq(Stmt *stmt, Stmts *stmts) : stmt_(stmt), stmts_(stmts) {}
+  StmtsBlock(Stmt **stmts, int count, const int *starts)
+      : stmts_(stmts), count_(count), starts_(starts) {}
   std::string unparse();
   std::string CppCode();
-  ~StmtsSeq();
+  void Save(AstWriter *out);
+  int count(void) const { return count_; }
+  Stmt *stmt(int i) const { return stmts_[i]; }
+  int start(int i) const { return starts_[i]; }
 
  private:
-  StmtsSeq() : stmt_(NULL), stmts_(NULL) {}
-  StmtsSeq(const StmtsSeq &) {}
-  Stmt *stmt_;
-  Stmts *stmts_;
+  StmtsBlock() : stmts_(NULL), count_(0), starts_(NULL) {}
+  StmtsBlock(const StmtsBlock &) {}
+  Stmt **stmts_;
+  int count_;
+  const int *starts_;
 };
 
 /*!
@@ -119,6 +127,9 @@ class Stmt : public Node {
  public:
   virtual std::string unparse(void) = 0;
   virtual std::string CppCode(void) = 0;
+  virtual void Save(AstWriter *out) = 0;
+  /// This statement as a StmtsStmt, or nullptr if it is another kind.
+  virtual StmtsStmt *AsStmtsStmt() { return nullptr; }
   virtual ~Stmt() {}
 };
 
@@ -131,6 +142,7 @@ class DeclStmt : public Stmt {
   explicit DeclStmt(Decl *decl) : decl_(decl) {}
   std::string unparse();
   std::string CppCode();
+  void Save(AstWriter *out);
   ~DeclStmt() {}
 
  private:
@@ -146,7 +158,8 @@ class AssignStmt : public Stmt {
   AssignStmt(VarName *var, Expr *expr) : varName_(var), expr_(expr) {}
   std::string unparse();
   std::string CppCode();
-  ~AssignStmt();
+  void Save(AstWriter *out);
+  Expr *expr() const { return expr_; }
  private:
   VarName *varName_;
   Expr *expr_;
@@ -162,7 +175,7 @@ class AssignMatrixStmt : public Stmt {
                    varName_(var), expr1_(expr1), expr2_(expr2), expr3_(expr3) {}
   std::string unparse();
   std::string CppCode();
-  ~AssignMatrixStmt();
+  void Save(AstWriter *out);
  private:
   VarName *varName_;
   Expr *expr1_;
@@ -178,8 +191,8 @@ class PrintStmt : public Stmt {
  public:
   explicit PrintStmt(Expr *expr) : expr_(expr) {}
   std::string CppCode();
+  void Save(AstWriter *out);
   std::string unparse();
-  ~PrintStmt();
  private:
   Expr *expr_;
 };
@@ -194,8 +207,8 @@ class IfStmt : public Stmt {
  public:
   IfStmt(Expr *expr, Stmt *stmt) : expr_(expr), stmt_(stmt) {}
   std::string CppCode();
+  void Save(AstWriter *out);
   std::string unparse();
-  ~IfStmt();
  private:
   Expr *expr_;
   Stmt *stmt_;
@@ -211,7 +224,7 @@ class IfElseStmt : public Stmt {
   stmt1_(stmt1), stmt2_(stmt2) {}
   std::string unparse();
   std::string CppCode();
-  ~IfElseStmt();
+  void Save(AstWriter *out);
  private:
   Expr *expr_;
   Stmt *stmt1_;
@@ -225,9 +238,11 @@ class IfElseStmt : public Stmt {
 class StmtsStmt : public Stmt {
  public:
   explicit StmtsStmt(Stmts *stmts) : stmts_(stmts) {}
-  ~StmtsStmt();
   std::string unparse();
   std::string CppCode();
+  void Save(AstWriter *out);
+  StmtsStmt *AsStmtsStmt() { return this; }
+  Stmts *stmts() const { return stmts_; }
  private:
   Stmts *stmts_;
 };
@@ -241,7 +256,7 @@ class SemiColonStmt : public Stmt {
  public:
   std::string unparse();
   std::string CppCode();
-  ~SemiColonStmt();
+  void Save(AstWriter *out);
 };
 
 /*!
@@ -254,7 +269,7 @@ class RepeatStmt : public Stmt {
   : varName_(varName), expr1_(expr1), expr2_(expr2), stmt_(stmt) {}
   std::string unparse();
   std::string CppCode();
-  ~RepeatStmt();
+  void Save(AstWriter *out);
  private:
   VarName *varName_;
   Expr *expr1_;
@@ -271,7 +286,7 @@ class WhileStmt : public Stmt {
   WhileStmt(Expr *expr, Stmt *stmt) : expr_(expr), stmt_(stmt) {}
   std::string unparse();
   std::string CppCode();
-  ~WhileStmt();
+  void Save(AstWriter *out);
  private:
   Expr *expr_;
   Stmt *stmt_;
@@ -285,6 +300,7 @@ class Decl : public Node {
  public:
   virtual std::string unparse(void) = 0;
   virtual std::string CppCode(void) = 0;
+  virtual void Save(AstWriter *out) = 0;
   virtual ~Decl() {}
 };
 
@@ -296,14 +312,14 @@ class Decl : public Node {
  */
 class SimpleDecl : public Decl {
  public:
-  SimpleDecl(std::string *kwdType, VarName *varName) :
+  SimpleDecl(const char *kwdType, VarName *varName) :
            kwdType_(kwdType), varName_(varName) {}
   std::string unparse();
   std::string CppCode();
-  ~SimpleDecl();
+  void Save(AstWriter *out);
 
  private:
-  std::string *kwdType_;
+  const char *kwdType_;
   VarName *varName_;
 };
 
@@ -319,7 +335,7 @@ class LongMatrixDecl : public Decl {
   expr2_(expr2), var2_(var2), var3_(var3), expr3_(expr3) {}
   std::string unparse();
   std::string CppCode();
-  ~LongMatrixDecl();
+  void Save(AstWriter *out);
  private:
   VarName *var1_;
   Expr *expr1_;
@@ -338,7 +354,7 @@ class ShortMatrixDecl : public Decl {
   ShortMatrixDecl(VarName *var, Expr *expr) : varName_(var), expr_(expr) {}
   std::string unparse();
   std::string CppCode();
-  ~ShortMatrixDecl();
+  void Save(AstWriter *out);
  private:
   VarName *varName_;
   Expr *expr_;
@@ -352,6 +368,9 @@ class Expr : public Node {
  public:
   virtual std::string unparse() = 0;
   virtual std::string CppCode() = 0;
+  virtual void Save(AstWriter *out) = 0;
+  /// This expression as a BinOpExpr, or nullptr if it is another kind.
+  virtual BinOpExpr *AsBinOp() { return nullptr; }
   virtual ~Expr() {}
 };
 
@@ -364,7 +383,7 @@ class LetExpr : public Expr {
   LetExpr(Stmts *stmts, Expr *expr) : stmts_(stmts), expr_(expr) {}
   std::string unparse();
   std::string CppCode();
-  ~LetExpr();
+  void Save(AstWriter *out);
  private:
   Stmts* stmts_;
   Expr* expr_;
@@ -377,17 +396,27 @@ class LetExpr : public Expr {
  * Where operator is part of the set
  * {'*', '/', '+', '-', '>', '>=', '<',
  *  '<=', '==', '!=', '&&', '||'}
+ *
+ * The parser builds chains of operators of the same precedence left
+ * associatively, so a long chain is a long left spine. It is emitted
+ * by walking the spine in a loop rather than by recursing down it.
  */
 class BinOpExpr : public Expr {
  public:
-  BinOpExpr(Expr *left, std::string *op, Expr *right) : left_(left),
+  BinOpExpr(Expr *left, const char *op, Expr *right) : left_(left),
   operator_(op), right_(right) {}
   std::string unparse();
   std::string CppCode();
-  ~BinOpExpr();
+  void Save(AstWriter *out);
+  BinOpExpr *AsBinOp() { return this; }
+  Expr *left() const { return left_; }
+  const char *op() const { return operator_; }
+  Expr *right() const { return right_; }
  private:
+  std::string Emit(std::string (Expr::*emit)());
+
   Expr * left_;
-  std::string *operator_;
+  const char *operator_;
   Expr * right_;
 };
 
@@ -400,7 +429,7 @@ class FunctionExpr : public Expr {
   FunctionExpr(VarName *var, Expr *expr) : varName_(var), expr_(expr) {}
   std::string unparse();
   std::string CppCode();
-  ~FunctionExpr();
+  void Save(AstWriter *out);
  private:
   VarName *varName_;
   Expr *expr_;
@@ -416,7 +445,7 @@ class MatrixExpr : public Expr {
              varName_(var), expr1_(expr1), expr2_(expr2) {}
   std::string unparse();
   std::string CppCode();
-  ~MatrixExpr();
+  void Save(AstWriter *out);
  private:
   VarName *varName_;
   Expr *expr1_;
@@ -433,7 +462,7 @@ class IfExpr : public Expr {
   expr2_(expr2), expr3_(expr3) {}
   std::string unparse();
   std::string CppCode();
-  ~IfExpr();
+  void Save(AstWriter *out);
  private:
   Expr *expr1_;
   Expr *expr2_;
@@ -449,24 +478,31 @@ class ParenExpr : public Expr {
   explicit ParenExpr(Expr *expr) : expr_(expr) {}
   std::string unparse();
   std::string CppCode();
-  ~ParenExpr();
+  void Save(AstWriter *out);
  private:
   Expr *expr_;
 };
 
 /*!
- * Class used for variable names
+ * Class used for variable names. A variable name is stored as its
+ * symbol in the parse's symbol table, so two VarNames name the same
+ * variable exactly when their symbols are equal; the name itself is
+ * only looked up when it is emitted.
  */
 class VarName : public Expr {
  public:
-  explicit VarName(std::string lexeme) : lexeme_(lexeme) {}
+  VarName(int symbol, const scanner::SymbolTable *symbols)
+      : symbol_(symbol), symbols_(symbols) {}
   std::string unparse();
   std::string CppCode();
+  void Save(AstWriter *out);
+  int symbol(void) const { return symbol_; }
   ~VarName() {}
  private:
-  VarName() : lexeme_((std::string) "") {}
+  VarName() : symbol_(-1), symbols_(nullptr) {}
   VarName(const VarName &) {}
-  std::string lexeme_;
+  int symbol_;
+  const scanner::SymbolTable *symbols_;
 };
 
 /*!
@@ -476,12 +512,12 @@ class VarName : public Expr {
  */
 class AnyConst : public Expr {
  public:
-  explicit AnyConst(std::string *s) : constStr_(s) {}
+  explicit AnyConst(const char *s) : constStr_(s) {}
   std::string unparse();
   std::string CppCode();
-  ~AnyConst();
+  void Save(AstWriter *out);
  private:
-  std::string *constStr_;
+  const char *constStr_;
 };
 
 
@@ -494,7 +530,7 @@ class NotExpr : public Expr {
   explicit NotExpr(Expr *expr) : expr_(expr) {}
   std::string unparse();
   std::string CppCode();
-  ~NotExpr();
+  void Save(AstWriter *out);
  private:
   Expr *expr_;
 };
@@ -507,7 +543,7 @@ class TrueKwdExpr : public Expr {
  public:
   std::string unparse();
   std::string CppCode();
-  ~TrueKwdExpr();
+  void Save(AstWriter *out);
 };
 
 /*!
@@ -518,7 +554,7 @@ class FalseKwdExpr : public Expr {
  public:
   std::string unparse();
   std::string CppCode();
-  ~FalseKwdExpr();
+  void Save(AstWriter *out);
 };
 
 } /* namespace ast */
@@ -0,0 +1,75 @@
+#ifndef PROJECT_INCLUDE_AST_CACHE_H_
+#define PROJECT_INCLUDE_AST_CACHE_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include "include/parse_result.h"
+#include "include/parser.h"
+#include "include/read_input.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+namespace fcal {
+namespace parser {
+
+/*******************************************************************************
+ * Class Declarations
+ ******************************************************************************/
+/*!
+ * \brief A directory of trees saved from earlier parses.
+ *
+ * Parse looks for a tree saved from the same text by the same version
+ * of the translator. When there is one, its file is mapped and the tree
+ * rebuilt with LoadTree in one pass, without scanning or parsing.
+ * Otherwise the text is parsed, and the tree saved if the parse
+ * succeeded.
+ *
+ * Each entry is named by a 64 bit hash of kVersion and the text, and
+ * holds the text, the names of the symbol table and the tree saved by
+ * an AstWriter. The hash is not collision resistant, so an entry is
+ * only used for the text saved in it. Entries are written under a
+ * temporary name and then renamed, so processes may share a directory.
+ * An entry that cannot be read, or is not well formed, counts as a
+ * miss. Numbers are saved in the byte order of the machine, so a cache
+ * should not be shared between machines of different byte orders.
+ */
+class AstCache {
+ public:
+  /// Bump whenever the tree classes or the saved format change, so that
+  /// entries saved by older translators are missed.
+  static const uint32_t kVersion = 3;
+
+  /// Use the directory dir, which must exist.
+  explicit AstCache(const std::string &dir) : dir_(dir) {}
+
+  /// Load the tree of text from the cache, or parse it with parser and
+  /// save the tree for next time.
+  ParseResult Parse(Parser *parser, const char *text);
+  ParseResult Parse(Parser *parser, const scanner::InputBuffer &input) {
+    return Parse(parser, input.text());
+  }
+
+  /// Load the tree of text into pr, if the cache has it.
+  bool Load(const char *text, ParseResult *pr);
+
+ private:
+  AstCache(const AstCache &);
+  AstCache &operator=(const AstCache &);
+
+  std::string Path(uint64_t hash);
+  bool Load(const char *text, uint64_t hash, size_t size, ParseResult *pr);
+  bool Store(const char *text, uint64_t hash, size_t size,
+             ParseResult *pr);
+
+  std::string dir_;
+}; /* class AstCache */
+
+} /* namespace parser */
+} /* namespace fcal */
+
+#endif  // PROJECT_INCLUDE_AST_CACHE_H_
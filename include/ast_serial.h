@@ -0,0 +1,117 @@
+#ifndef PROJECT_INCLUDE_AST_SERIAL_H_
+#define PROJECT_INCLUDE_AST_SERIAL_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <stddef.h>
+#include <string>
+#include "include/arena.h"
+#include "include/ast.h"
+#include "include/symbol_table.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+namespace fcal {
+namespace ast {
+
+/*******************************************************************************
+ * Constant Definitions
+ ******************************************************************************/
+/// The tag that starts each node in a saved tree. kNullNode stands for
+/// a missing child. The values are part of the saved format, so new
+/// kinds go at the end.
+enum NodeKind {
+  kNullNode,
+  kRootNode,
+  kStmtsBlockNode,
+  kDeclStmtNode,
+  kAssignStmtNode,
+  kAssignMatrixStmtNode,
+  kPrintStmtNode,
+  kIfStmtNode,
+  kIfElseStmtNode,
+  kStmtsStmtNode,
+  kSemiColonStmtNode,
+  kRepeatStmtNode,
+  kWhileStmtNode,
+  kSimpleDeclNode,
+  kLongMatrixDeclNode,
+  kShortMatrixDeclNode,
+  kLetExprNode,
+  kBinOpExprNode,
+  kFunctionExprNode,
+  kMatrixExprNode,
+  kIfExprNode,
+  kParenExprNode,
+  kVarNameNode,
+  kAnyConstNode,
+  kNotExprNode,
+  kTrueKwdExprNode,
+  kFalseKwdExprNode,
+  kNumNodeKinds
+};
+
+/*******************************************************************************
+ * Class Declarations
+ ******************************************************************************/
+/*!
+ * \brief Saves a tree as a compact string of bytes.
+ *
+ * Nodes are saved in post order: the children of a node, in the order
+ * its constructor takes them, and then its tag followed by any fields
+ * that are not nodes. LoadTree can then rebuild the tree in one pass
+ * over the bytes with a stack of the nodes made so far, and needs no
+ * recursion however deep the tree is.
+ *
+ * Fields are saved as
+ *   Int      - 4 bytes in the byte order of the machine
+ *   String   - an Int length followed by the characters
+ *   Spelling - 1 byte, the terminal whose spelling it is
+ * VarNames are saved as their symbols, so the symbol table the tree
+ * was parsed with must be saved along with it.
+ */
+class AstWriter {
+ public:
+  AstWriter(void) : bytes_() {}
+
+  /// Save a node and its children, or kNullNode for nullptr.
+  void Save(Node *node) {
+    if (node) {
+      node->Save(this);
+    } else {
+      Tag(kNullNode);
+    }
+  }
+
+  void Tag(NodeKind kind) { bytes_ += static_cast<char>(kind); }
+  void Int(int value);
+  void String(const char *text);
+  /// Save the spelling of a keyword or operator, which must be one of
+  /// the spellings in kTokenSpecs.
+  void Spelling(const char *spelling);
+
+  const std::string &bytes(void) const { return bytes_; }
+
+ private:
+  std::string bytes_;
+}; /* class AstWriter */
+
+/*******************************************************************************
+ * Functions
+ ******************************************************************************/
+/*!
+ * Rebuild the tree of a program saved by an AstWriter from the size
+ * bytes at data. Its nodes and strings are made in arena, so data need
+ * not outlive the call, and its VarNames refer to symbols. Returns
+ * nullptr if the bytes are not exactly one saved tree, or the tree is
+ * not a whole program.
+ */
+Root *LoadTree(const char *data, size_t size, parser::Arena *arena,
+               const scanner::SymbolTable *symbols);
+
+} /* namespace ast */
+} /* namespace fcal */
+
+#endif  // PROJECT_INCLUDE_AST_SERIAL_H_
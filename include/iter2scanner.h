@@ -4,6 +4,7 @@
 /*******************************************************************************
  * Includes
  ******************************************************************************/
+#include "include/token_spec.h"
 
 /*******************************************************************************
  * Namespaces
@@ -16,66 +17,38 @@ namespace scanner {
  ******************************************************************************/
 /*
  * This enumerated type is used to keep track of what kind of
- * construct was matched.
+ * construct was matched. There is one terminal per entry of
+ * FCAL_TOKENS, in the same order.
  */
+#define FCAL_TOKEN_ENUM(name, spelling, pattern, nud, led, lbp, desc) \
+  k##name,
 enum kTokenEnumType {
-  kIntKwd,
-  kFloatKwd,
-  kBoolKwd,
-  kTrueKwd,
-  kFalseKwd,
-  kStringKwd,
-  kMatrixKwd,
-  kLetKwd,
-  kInKwd,
-  kEndKwd,
-  kIfKwd,
-  kThenKwd,
-  kElseKwd,
-  kRepeatKwd,
-  kWhileKwd,
-  kPrintKwd,
-  kToKwd,
-
-  // Constants
-  kIntConst,
-  kFloatConst,
-  kStringConst,
-
-  // Names
-  kVariableName,
+  FCAL_TOKENS(FCAL_TOKEN_ENUM)
+};
+#undef FCAL_TOKEN_ENUM
+typedef enum kTokenEnumType TokenType;
 
-  // Punctuation
-  kLeftParen,
-  kRightParen,
-  kLeftCurly,
-  kRightCurly,
-  kLeftSquare,
-  kRightSquare,
-  kSemiColon,
-  kColon,
+/// The number of terminals.
+static const int kNumTerminals = kLexicalError + 1;
 
-  // Operators
-  kAssign,
-  kPlusSign,
-  kStar,
-  kDash,
-  kForwardSlash,
-  kLessThan,
-  kLessThanEqual,
-  kGreaterThan,
-  kGreaterThanEqual,
-  kEqualsEquals,
-  kNotEquals,
-  kAndOp,
-  kOrOp,
-  kNotOp,
+/// What FCAL_TOKENS says about one terminal; see there.
+struct TokenSpec {
+  const char *spelling;
+  const char *pattern;
+  int lbp;
+  const char *description;
+};
 
-  // Special terminal types
-  kEndOfFile,
-  kLexicalError
+/// The TokenSpec of each terminal, indexed by TokenType.
+#define FCAL_TOKEN_SPEC(name, spelling, pattern, nud, led, lbp, desc) \
+  { spelling, pattern, lbp, desc },
+constexpr TokenSpec kTokenSpecs[] = {
+  FCAL_TOKENS(FCAL_TOKEN_SPEC)
 };
-typedef enum kTokenEnumType TokenType;
+#undef FCAL_TOKEN_SPEC
+
+static_assert(sizeof(kTokenSpecs) / sizeof(kTokenSpecs[0]) == kNumTerminals,
+              "every terminal needs a TokenSpec");
 
 } /* namespace scanner */
 } /* namespace fcal */
@@ -0,0 +1,46 @@
+#ifndef PROJECT_INCLUDE_LEXER_H_
+#define PROJECT_INCLUDE_LEXER_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "include/iter2scanner.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+namespace fcal {
+namespace scanner {
+
+/*******************************************************************************
+ * Functions
+ ******************************************************************************/
+/*!
+ * MatchToken() - Recognise the token at the start of text in a single
+ * left-to-right pass, without running any regular expressions.
+ *
+ * The state machine gives the same answer as trying every pattern in
+ * LexerTables::token_regex and keeping the longest match (earliest terminal
+ * on ties): keywords win over variable names of the same length, an
+ * unterminated string constant or a lone '&' / '|' is a one character
+ * lexical error, and so on.
+ *
+ * text must not start with white space or a comment and must be null
+ * terminated.
+ *
+ * RETURN:
+ *     int - The number of characters in the token (at least 1 when
+ *           text is non-empty). *terminal receives the token kind.
+ */
+int MatchToken(const char *text, TokenType *terminal);
+
+/*!
+ * KeywordType() - Classify an already lexed identifier of the given length
+ * as one of the keyword terminals, or kVariableName.
+ */
+TokenType KeywordType(const char *text, int length);
+
+} /* namespace scanner */
+} /* namespace fcal */
+
+#endif  // PROJECT_INCLUDE_LEXER_H_
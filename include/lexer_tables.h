@@ -0,0 +1,56 @@
+#ifndef PROJECT_INCLUDE_LEXER_TABLES_H_
+#define PROJECT_INCLUDE_LEXER_TABLES_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "include/iter2scanner.h"
+#include "include/regex.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+namespace fcal {
+namespace scanner {
+
+/*******************************************************************************
+ * Class Declarations
+ ******************************************************************************/
+/*!
+ * \brief The compiled regular expressions of the FCAL dsl.
+ *
+ * There is one instance, shared by every Scanner in every thread. It is
+ * compiled the first time Get() is called, is never changed after that,
+ * and is freed when the program exits. Scanning itself runs MatchToken
+ * and SkipWhitespaceAndComments, whose tables are compile-time
+ * constants, so a program that never asks for a regex never compiles
+ * one.
+ */
+class LexerTables {
+ public:
+  /// The shared tables. C++11 runs the initialisation of a local static
+  /// exactly once, even when several threads get here at the same time.
+  static const LexerTables &Get(void);
+
+  /// The regex for a terminal, the reference definition of its tokens.
+  regex_t *token_regex(int index) const { return token_regex_[index]; }
+  regex_t *white_space(void) const { return white_space_; }
+  regex_t *block_comment(void) const { return block_comment_; }
+  regex_t *line_comment(void) const { return line_comment_; }
+
+ private:
+  LexerTables(void);
+  ~LexerTables(void);
+  LexerTables(const LexerTables &);
+  LexerTables &operator=(const LexerTables &);
+
+  regex_t *token_regex_[kNumTerminals];
+  regex_t *white_space_;
+  regex_t *block_comment_;
+  regex_t *line_comment_;
+}; /* class LexerTables */
+
+} /* namespace scanner */
+} /* namespace fcal */
+
+#endif  // PROJECT_INCLUDE_LEXER_TABLES_H_
@@ -0,0 +1,50 @@
+#ifndef PROJECT_INCLUDE_LINE_INDEX_H_
+#define PROJECT_INCLUDE_LINE_INDEX_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <vector>
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+namespace fcal {
+namespace scanner {
+
+/*******************************************************************************
+ * Class Declarations
+ ******************************************************************************/
+/*!
+ * \brief Maps offsets in a source text to line and column numbers.
+ *
+ * Tokens only record their offset, so the scanner never counts lines.
+ * The offsets at which lines start are found the first time a position
+ * is asked for, using memchr to jump from newline to newline, and each
+ * lookup after that is a binary search. A program that scans and parses
+ * without errors never builds the index.
+ */
+class LineIndex {
+ public:
+  LineIndex(void) : text_(""), line_starts_(), built_(false) {}
+
+  /// Forget any index and refer to a new text, which is not copied.
+  void Reset(const char *text);
+
+  /// The 1 based line and column of the character at offset. Columns
+  /// count characters, so a tab is one column.
+  void Locate(int offset, int *line, int *column);
+
+ private:
+  void Build(void);
+
+  const char *text_;
+  std::vector<int> line_starts_;  // offset of the first character of
+                                  // each line, in order
+  bool built_;
+}; /* class LineIndex */
+
+} /* namespace scanner */
+} /* namespace fcal */
+
+#endif  // PROJECT_INCLUDE_LINE_INDEX_H_
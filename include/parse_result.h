@@ -4,8 +4,11 @@
 /*******************************************************************************
  * Includes
  ******************************************************************************/
+#include <memory>
 #include <string>
+#include "include/arena.h"
 #include "include/ast.h"
+#include "include/symbol_table.h"
 
 /*******************************************************************************
  * Namespaces
@@ -18,19 +21,41 @@ namespace parser {
  ******************************************************************************/
 class ParseResult {
  public:
-  ParseResult(void) : errors_(), ast_(NULL), ok_(true) {}
+  ParseResult(void) : errors_(), ast_(NULL), ok_(true), symbols_(),
+                          arena_(), tree_bytes_(0) {}
 
   bool ok(void) const { return ok_; }
   void ok(bool result_in) { ok_ = result_in; }
   std::string errors(void) const { return errors_; }
   void errors(const std::string str_in) { errors_ = str_in;}
-  ast::Node *ast(void) { return ast_; }
+  ast::Node *ast(void) const { return ast_; }
   void ast(ast::Node * Node_ptr) { ast_ = Node_ptr; }
+  /// The symbol table the VarNames of the tree were interned into. Keep
+  /// the result (or a copy of this pointer) for as long as the tree is
+  /// unparsed or translated.
+  std::shared_ptr<scanner::SymbolTable> symbols(void) const {
+    return symbols_;
+  }
+  void symbols(std::shared_ptr<scanner::SymbolTable> table) {
+    symbols_ = table;
+  }
+  /// The arena the nodes and strings of the tree were made in. The tree
+  /// is freed with the last result holding it.
+  std::shared_ptr<Arena> arena(void) const { return arena_; }
+  void arena(std::shared_ptr<Arena> arena_in) { arena_ = arena_in; }
+  /// The bytes of the arena that the tree used when the text behind it
+  /// was last parsed whole. Parser::Reparse compares the arena with it
+  /// to tell how much the reparses since have added.
+  size_t tree_bytes(void) const { return tree_bytes_; }
+  void tree_bytes(size_t bytes) { tree_bytes_ = bytes; }
 
  private:
   std::string errors_;
   ast::Node *ast_;
   bool ok_;
+  std::shared_ptr<scanner::SymbolTable> symbols_;
+  std::shared_ptr<Arena> arena_;
+  size_t tree_bytes_;
 };
 
 } /* namespace parser */
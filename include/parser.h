@@ -4,17 +4,19 @@
 /*******************************************************************************
  * Includes
  ******************************************************************************/
+#include <memory>
 #include <string>
+#include <vector>
+#include "include/arena.h"
+#include "include/line_index.h"
 #include "include/parse_result.h"
+#include "include/read_input.h"
 #include "include/scanner.h"
 
 /*******************************************************************************
  * Namespaces
  ******************************************************************************/
 namespace fcal {
-namespace scanner {
-class ExtToken;
-} /* namespace scanner */
 namespace parser {
 
 /*******************************************************************************
@@ -39,41 +41,92 @@ namespace parser {
 class Parser {
  public:
   Parser(void)
-      : curr_token_(nullptr), prev_token_(nullptr),
-        stokens_(nullptr), scanner_(nullptr) {}
+      : tokens_(), curr_(0), prev_(0), streaming_(false),
+        scan_offset_(0), symbols_(), arena_(), stmt_stack_(),
+        start_stack_(), failed_(false), error_(), lines_(), scanner_(nullptr) {}
   ~Parser(void);
 
+  /// Parse a program. Tokens refer into text instead of copying it, so
+  /// text must stay valid until Parse returns; the AST keeps copies of
+  /// any lexemes it needs in the arena of the result.
   ParseResult Parse(const char *text);
+  /// Parse the text of an open input file, which the caller keeps
+  /// open for the duration of the parse.
+  ParseResult Parse(const scanner::InputBuffer &input) {
+    return Parse(input.text());
+  }
+
+  /// Parse text, the program of previous after the old_length
+  /// characters at offset begin were replaced with new_length others,
+  /// parsing again only the statements the edit touches and reusing
+  /// the rest of the tree of previous. The result is the one Parse
+  /// would give. previous must have been parsed from the text before
+  /// the edit; its symbol table and arena are shared with the result,
+  /// so it must not be used on another thread during the call.
+  ///
+  /// The statements an edit replaces are not freed, nor are those made
+  /// by a reparse that had to fall back to Parse, until every result
+  /// sharing the arena is gone, so an arena grows with each reparse.
+  /// Once it holds kMaxReparseGrowth times as much as the tree did when
+  /// the text was last parsed whole, Reparse parses the whole text into
+  /// a new arena instead, so that a long run of edits keeps the memory
+  /// of a result within a few times the size of its tree.
+  static const size_t kMaxReparseGrowth = 4;
+  ParseResult Reparse(const ParseResult &previous, const char *text,
+                      int begin, int old_length, int new_length);
+
+  /// Drop everything left from the last parse, so that the parser can
+  /// be kept for the next one. The token storage and scratch space are
+  /// kept for reuse, and so are the arena and symbol table of the last
+  /// tree once no ParseResult holds them any more. Parse calls this
+  /// itself; call it to let go of the last source text early.
+  void Reset(void);
+
+  /// In streaming mode Parse does not scan the program up front. Tokens
+  /// are scanned a small batch at a time as next_token reaches the end
+  /// of those already scanned, and tokens behind the parser are freed,
+  /// so the token memory stays the same however long the program is.
+  bool streaming(void) const { return streaming_; }
+  void streaming(bool on) { streaming_ = on; }
   // Parser methods for the nonterminals:
 
-  ParseResult ParseProgram();
-  ParseResult parse_decl();
-  ParseResult parse_standard_decl();
-  ParseResult parse_matrix_decl();
-  ParseResult parse_stmts();
-  ParseResult parse_stmt();
-  ParseResult parse_expr(int rbp);
+  // Each production returns the node it parsed as its static type, so
+  // no result is cast on the way up. A failed production returns
+  // nullptr and sets failed_.
+  ast::Root *ParseProgram();
+  ast::Decl *parse_decl();
+  ast::Decl *parse_standard_decl();
+  ast::Decl *parse_matrix_decl();
+  ast::Stmts *parse_stmts();
+  ast::Stmt *parse_stmt();
+  ast::Expr *parse_expr(int rbp);
   // methods for parsing productions for Expr
-  ParseResult parse_true_kwd();
-  ParseResult parse_false_kwd();
-  ParseResult parse_int_const();
-  ParseResult parse_float_const();
-  ParseResult parse_string_const();
-  ParseResult parse_char_const();
-  ParseResult parse_variable_name();
-  ParseResult parse_nested_expr();
-  ParseResult parse_not_expr();
-  ParseResult parse_let_expr();
-  ParseResult parse_if_expr();
-  ParseResult parse_addition(ParseResult left);
-  ParseResult parse_multiplication(ParseResult left);
-  ParseResult parse_subtraction(ParseResult left);
-  ParseResult parse_division(ParseResult left);
-
-  ParseResult parse_relational_expr(ParseResult left);
+  ast::Expr *parse_true_kwd();
+  ast::Expr *parse_false_kwd();
+  ast::Expr *parse_int_const();
+  ast::Expr *parse_float_const();
+  ast::Expr *parse_string_const();
+  ast::Expr *parse_char_const();
+  ast::Expr *parse_variable_name();
+  ast::Expr *parse_nested_expr();
+  ast::Expr *parse_not_expr();
+  ast::Expr *parse_let_expr();
+  ast::Expr *parse_if_expr();
+  ast::Expr *parse_addition(ast::Expr *left);
+  ast::Expr *parse_multiplication(ast::Expr *left);
+  ast::Expr *parse_subtraction(ast::Expr *left);
+  ast::Expr *parse_division(ast::Expr *left);
+
+  ast::Expr *parse_relational_expr(ast::Expr *left);
+
+  // The nud of a token parses the expression it starts, and the led
+  // of a token parses the rest of the expression whose left operand
+  // it follows. FCAL_TOKENS names them for each terminal.
+  typedef ast::Expr *(Parser::*NudHandler)();
+  typedef ast::Expr *(Parser::*LedHandler)(ast::Expr *left);
 
   // Helper function used by the parser.
-  void match(const scanner::TokenType &tt);
+  bool match(const scanner::TokenType &tt);
   bool attempt_match(const scanner::TokenType &tt);
   bool next_is(const scanner::TokenType &tt);
   void next_token(void);
@@ -83,13 +136,57 @@ class Parser {
   std::string make_error_msg(const scanner::TokenType &terminal);
   std::string make_error_msg_expected(const scanner::TokenType &terminal);
   std::string make_error_msg(const char *msg);
+  void fail(const std::string &msg);
+  std::string error_location(void);
+  ast::Expr *no_nud();
+  ast::Expr *no_led(ast::Expr *left);
+  void refill_tokens();
+  ast::StmtsBlock *make_block(size_t first_stmt, size_t first_start);
+  ast::StmtsBlock *reparse_block(ast::StmtsBlock *block, int base,
+                                 int begin, int end, int shift);
+  void push_stmts(ast::StmtsBlock *block, int from, int to, int shift);
+  ast::VarName *prev_var_name();
+  const char *prev_spelling();
+  int prev_lbp();
+  const char *prev_lexeme();
+
+  // The scanned program, walked by index. In streaming mode tokens_
+  // only holds a window of the program, and scan_offset_ is where
+  // scanning resumes in the source text.
+  scanner::TokenStream tokens_;
+  int curr_;
+  int prev_;
+  bool streaming_;
+  int scan_offset_;
 
-  scanner::ExtToken *tokens_;
-  scanner::ExtToken *curr_token_;
-  scanner::ExtToken *prev_token_;
+  // Variable names of the current parse are interned here. Each parse
+  // gets a new table, which the ParseResult shares with its tree.
+  std::shared_ptr<scanner::SymbolTable> symbols_;
+
+  // The nodes and strings of the tree are made in arena_, which is new
+  // for each parse and shared with the ParseResult like symbols_.
+  std::shared_ptr<Arena> arena_;
+
+  // The statements of the blocks being parsed, innermost last, and the
+  // offsets they start at; see StmtsBlock.
+  std::vector<ast::Stmt *> stmt_stack_;
+  std::vector<int> start_stack_;
+
+  // Syntax errors are not thrown. The first one is kept in error_ and
+  // sets failed_, which every production checks after each token it
+  // matches and each production it calls, returning at once when it
+  // is set, so a failing parse unwinds with ordinary returns.
+  bool failed_;
+  std::string error_;
+
+  // Line and column numbers for error messages, only worked out when a
+  // parse fails.
+  scanner::LineIndex lines_;
 
-  scanner::Token *stokens_;
   scanner::Scanner *scanner_;
+
+  static const NudHandler kNud[scanner::kNumTerminals];
+  static const LedHandler kLed[scanner::kNumTerminals];
 };
 
 } /* namespace parser */
@@ -0,0 +1,86 @@
+#ifndef PROJECT_INCLUDE_PARSER_POOL_H_
+#define PROJECT_INCLUDE_PARSER_POOL_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <stddef.h>
+#include <mutex>
+#include <vector>
+#include "include/parser.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+namespace fcal {
+namespace parser {
+
+/*******************************************************************************
+ * Class Declarations
+ ******************************************************************************/
+/*!
+ * \brief Parsers for worker threads to check out and give back.
+ *
+ * A parser keeps its token storage, arena and scratch space from one
+ * parse to the next, so a thread that parses many files should keep
+ * using the same one. Acquire hands out an idle parser, or a new one
+ * when none is idle, and the Lease it returns gives the parser back
+ * when it goes out of scope. At most max_idle parsers are kept idle;
+ * any more are freed as they come back.
+ *
+ * Any number of threads may acquire parsers at once, but each parser
+ * is only used by the thread holding its lease. Trees parsed with a
+ * pooled parser live in the arena of their ParseResult as usual, so
+ * they may outlive the lease.
+ */
+class ParserPool {
+ public:
+  class Lease {
+   public:
+    Lease(ParserPool *pool, Parser *parser) : pool_(pool), parser_(parser) {}
+    Lease(Lease &&other) : pool_(other.pool_), parser_(other.parser_) {
+      other.parser_ = nullptr;
+    }
+    ~Lease(void) {
+      if (parser_) pool_->Release(parser_);
+    }
+
+    Parser *operator->(void) const { return parser_; }
+    Parser &operator*(void) const { return *parser_; }
+    Parser *get(void) const { return parser_; }
+
+   private:
+    Lease(const Lease &);
+    Lease &operator=(const Lease &);
+
+    ParserPool *pool_;
+    Parser *parser_;
+  }; /* class Lease */
+
+  explicit ParserPool(size_t max_idle) : mutex_(), idle_(),
+                                         max_idle_(max_idle) {}
+  /// Frees the idle parsers. Every lease must have been given back.
+  ~ParserPool(void);
+
+  /// Check out a parser, which is not in streaming mode.
+  Lease Acquire(void);
+
+  /// The number of parsers waiting to be checked out.
+  size_t idle(void);
+
+ private:
+  ParserPool(const ParserPool &);
+  ParserPool &operator=(const ParserPool &);
+
+  void Release(Parser *parser);
+
+  // idle_ is guarded by mutex_.
+  std::mutex mutex_;
+  std::vector<Parser *> idle_;
+  size_t max_idle_;
+}; /* class ParserPool */
+
+} /* namespace parser */
+} /* namespace fcal */
+
+#endif  // PROJECT_INCLUDE_PARSER_POOL_H_
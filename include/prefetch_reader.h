@@ -0,0 +1,82 @@
+#ifndef PROJECT_INCLUDE_PREFETCH_READER_H_
+#define PROJECT_INCLUDE_PREFETCH_READER_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <stddef.h>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "include/read_input.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+namespace fcal {
+namespace scanner {
+
+/*******************************************************************************
+ * Class Declarations
+ ******************************************************************************/
+/*!
+ * \brief Loads a batch of source files ahead of the code translating them.
+ *
+ * A few I/O threads open the files in order with InputBuffer while the
+ * consumers parse the ones already loaded, so translation does not stop
+ * to wait on the disk. Next hands files out as they become ready, which
+ * need not be the order they were listed in.
+ *
+ * The files loaded but not yet handed out may hold at most
+ * max_bytes_in_flight bytes between them; a thread waits before loading
+ * a file that would go over. A single file larger than the limit is
+ * still loaded once nothing else is in flight.
+ */
+class PrefetchReader {
+ public:
+  PrefetchReader(const std::vector<std::string> &paths, int num_threads,
+                 size_t max_bytes_in_flight);
+  /// Stops the I/O threads; files not yet handed out are freed.
+  ~PrefetchReader(void);
+
+  /// Wait for another file to be loaded and take it. index is its place
+  /// in the list of paths, and the text of input is nullptr if it could
+  /// not be read. Returns false once every file has been handed out.
+  /// Any number of threads may call Next at once.
+  bool Next(int *index, std::unique_ptr<InputBuffer> *input);
+
+ private:
+  PrefetchReader(const PrefetchReader &);
+  PrefetchReader &operator=(const PrefetchReader &);
+
+  void Load(void);
+
+  typedef std::pair<int, InputBuffer *> Loaded;
+
+  // paths_ and max_bytes_in_flight_ are not changed once the threads
+  // start, and everything else below is guarded by mutex_. next_path_ is
+  // the next file for an I/O thread to load, ready_ holds the loaded
+  // files with their sizes counted in bytes_in_flight_, and handed_out_
+  // counts the files given to Next.
+  std::vector<std::string> paths_;
+  size_t max_bytes_in_flight_;
+  std::mutex mutex_;
+  std::condition_variable ready_changed_;
+  std::condition_variable space_freed_;
+  std::deque<std::pair<Loaded, size_t> > ready_;
+  size_t next_path_;
+  size_t handed_out_;
+  size_t bytes_in_flight_;
+  bool stopping_;
+  std::vector<std::thread> threads_;
+}; /* class PrefetchReader */
+
+} /* namespace scanner */
+} /* namespace fcal */
+
+#endif  // PROJECT_INCLUDE_PREFETCH_READER_H_
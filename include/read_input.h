@@ -1,17 +1,79 @@
 #ifndef PROJECT_INCLUDE_READ_INPUT_H_
 #define PROJECT_INCLUDE_READ_INPUT_H_
 
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <stddef.h>
+
 /*******************************************************************************
  * Namespaces
  ******************************************************************************/
 namespace fcal {
 namespace scanner {
 
+/*******************************************************************************
+ * Class Declarations
+ ******************************************************************************/
+/*!
+ * \brief Owns the null terminated text of a source file.
+ *
+ * Files of at least kMapThreshold bytes are mapped read only instead of
+ * copied, so their pages are shared with the page cache. The mapping is
+ * followed by a page of zeros, which terminates the text however long
+ * the file is and catches any read running off its end. Smaller files
+ * are read into a heap buffer with a single read, and pipes, such as
+ * standard input, are read in large blocks into a buffer that grows as
+ * it fills. Either way the text is freed when the InputBuffer is closed
+ * or destroyed, and can be handed to Scanner::Scan, Scanner::ScanNext
+ * or Parser::Parse without being copied again.
+ *
+ * A mapped file must not be truncated while it is open.
+ */
+class InputBuffer {
+ public:
+  /// Files smaller than this are read rather than mapped.
+  static const size_t kMapThreshold = 64 * 1024;
+
+  InputBuffer(void) : text_(nullptr), size_(0), mapping_(0), mapped_(false) {}
+  ~InputBuffer(void) { Close(); }
+
+  /// Load a file, closing any file already held. Returns false, with a
+  /// message on stdout, if the file cannot be opened or read.
+  bool Open(const char *filename);
+  /// Load everything that can be read from fd, which may be a pipe or
+  /// STDIN_FILENO and is left open. Returns false if a read fails.
+  bool Open(int fd);
+
+  /// Free the text.
+  void Close(void);
+
+  /// The text of the file, or nullptr if none is open.
+  const char *text(void) const { return text_; }
+  /// The length of the text, not counting its null.
+  size_t size(void) const { return size_; }
+  /// Whether the text is a mapping of the file.
+  bool mapped(void) const { return mapped_; }
+
+ private:
+  InputBuffer(const InputBuffer &);
+  InputBuffer &operator=(const InputBuffer &);
+
+  bool Load(int fd);
+  bool Map(int fd, size_t size);
+
+  char *text_;
+  size_t size_;
+  size_t mapping_;  // bytes mapped at text_, including the zero page
+  bool mapped_;
+}; /* class InputBuffer */
+
 /*******************************************************************************
  * Functions
  ******************************************************************************/
 char *ReadInput(int argc, char **argv);
 char *ReadInputFromFile(const char *filename);
+char *ReadInputFromStdin(void);
 
 } /* namespace scanner */
 } /* namespace fcal */
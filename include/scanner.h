@@ -6,7 +6,9 @@
  ******************************************************************************/
 #include <string>
 #include "include/token.h"
+#include "include/token_stream.h"
 #include "include/regex.h"
+#include "include/lexer_tables.h"
 
 /*******************************************************************************
  * Namespaces
@@ -25,93 +27,65 @@ namespace scanner {
  * You will also need to define a Scanner class with a scan and other methods
  ******************************************************************************/
 
+/*******************************************************************************
+ * Functions
+ ******************************************************************************/
+/*!
+ * The regular expression based skipping of white space and comments.
+ * Scan uses SkipWhitespaceAndComments instead; these are kept as the
+ * reference it is tested and benchmarked against.
+ */
+int consume_whitespace_and_comments(regex_t *white_space,
+regex_t *block_comment, regex_t *line_comment, const char *text);
+int consume_whitespace_and_comments(const char *text);
+
 /*******************************************************************************
  * Class Declarations
  ******************************************************************************/
 /*!
  * \brief Scanner class definition
- * Holds the array of regular expressions
- * for the FCAL dsl, a token iterator method to
- * scan the next token and a scan method that
- * will scan the entire program to make a linked
- * list of tokens.
+ * Provides a token iterator method to scan the
+ * next token and scan methods that scan the
+ * entire program. A scanner holds no state of
+ * its own; the regular expressions for the FCAL
+ * dsl live in the shared LexerTables, so making
+ * a scanner costs nothing and any number of
+ * threads can scan at once.
  */
 class Scanner {
     // public declarations
  public:
+  /// Scan a whole program into a list of tokens. The tokens point into
+  /// the given text rather than copying it, so it must outlive them.
   Token * Scan(const char *);
+  /// Scan a whole program into a contiguous token stream, ending with
+  /// a kEndOfFile token. The stream refers to the text by offset, and
+  /// variable names are interned into its symbol table if it has one.
+  void Scan(const char *, TokenStream *);
+  /// Scan at most count more tokens of source, starting offset
+  /// characters in, and append them to tokens, whose source must be the
+  /// same text. The kEndOfFile token is appended when the end of the
+  /// text is reached. Returns the offset to resume scanning from.
+  int ScanNext(const char *source, int offset, int count,
+               TokenStream *tokens);
+  /// Scan a whole program like Scan(const char *, TokenStream *), but
+  /// split it into at most num_chunks pieces that are lexed on their
+  /// own threads. The tokens are exactly those of the sequential scan.
+  void ScanParallel(const char *text, TokenStream *tokens, int num_chunks);
+  /// Update tokens, a scan of a program, after an edit replaced the
+  /// old_length characters at offset begin with new_length others;
+  /// text is the whole program after the edit. Only the tokens around
+  /// the edit are scanned again. Names not seen before get new symbols.
+  void Rescan(const char *text, int begin, int old_length, int new_length,
+              TokenStream *tokens);
   Token * token_iterator(const char *);
 
-  /*!
-  An initialized scanner instance receives all necessary
-  regular expressions for the FCAL dsl. These are stored
-  within the token_regex array private field.
-  */
-  Scanner() {
-    token_regex[kIntKwd] = make_regex("^int");
-    token_regex[kFloatKwd] = make_regex("^float");
-    token_regex[kBoolKwd] = make_regex("^boolean");
-    token_regex[kTrueKwd] = make_regex("^True");
-    token_regex[kFalseKwd] = make_regex("^False");
-    token_regex[kStringKwd] = make_regex("^string");
-    token_regex[kMatrixKwd] = make_regex("^matrix");
-    token_regex[kLetKwd] = make_regex("^let");
-    token_regex[kInKwd] = make_regex("^in");
-    token_regex[kEndKwd] = make_regex("^end");
-    token_regex[kIfKwd] = make_regex("^if");
-    token_regex[kThenKwd] = make_regex("^then");
-    token_regex[kElseKwd] = make_regex("^else");
-    token_regex[kRepeatKwd] = make_regex("^repeat");
-    token_regex[kPrintKwd] = make_regex("^print");
-    token_regex[kWhileKwd] = make_regex("^while");
-    token_regex[kToKwd] = make_regex("^to");
-
-    // Constants
-    token_regex[kIntConst] = make_regex("^[0-9]+");
-    token_regex[kFloatConst] = make_regex("^[0-9]*\\.?[0-9]*");
-    token_regex[kStringConst] = make_regex("^\"(\\.|[^\"])*\"");
-
-    // Names
-    token_regex[kVariableName] = make_regex("^[a-zA-Z_][a-zA-Z_0-9]*");
-
-    // Punctuation
-    token_regex[kLeftParen] = make_regex("^\\(");
-    token_regex[kRightParen] = make_regex("^)");
-    token_regex[kLeftCurly] = make_regex("^\\{");
-    token_regex[kRightCurly] = make_regex("^}");
-    token_regex[kLeftSquare] = make_regex("^\\[");
-    token_regex[kRightSquare] = make_regex("^]");
-    token_regex[kSemiColon] = make_regex("^;");
-    token_regex[kColon] = make_regex("^:");
-
-    // Operators
-    token_regex[kAssign] = make_regex("^=");
-    token_regex[kPlusSign] = make_regex("^\\+");
-    token_regex[kStar] = make_regex("^\\*");
-    token_regex[kDash] = make_regex("^-");
-    token_regex[kForwardSlash] = make_regex("^/");
-    token_regex[kLessThan] = make_regex("^<");
-    token_regex[kLessThanEqual] = make_regex("^<=");
-    token_regex[kGreaterThan] = make_regex("^>");
-    token_regex[kGreaterThanEqual] = make_regex("^>=");
-    token_regex[kEqualsEquals] = make_regex("^==");
-    token_regex[kNotEquals] = make_regex("^!=");
-    token_regex[kAndOp] = make_regex("^&&");
-    token_regex[kOrOp] = make_regex("^\\|\\|");
-    token_regex[kNotOp] = make_regex("^!");
-
-    // Special terminal types
-    token_regex[kEndOfFile] = make_regex("^EOF");
-    token_regex[kLexicalError] = make_regex("[^ ]");
-  }
-
-  /// Get a regex based on the index
+  /// Get a regex based on the index. token_iterator does not run these;
+  /// they remain the reference definition of each terminal. They are
+  /// compiled once and shared by all scanners; see LexerTables.
   regex_t * get_regex(int index) {
-    return token_regex[index];
+    return LexerTables::Get().token_regex(index);
   }
-
- private:
-  regex_t * token_regex[kLexicalError+1];
 }; /* class Scanner */
 }/* namespace scanner */
 }/* namespace fcal */
@@ -0,0 +1,61 @@
+#ifndef PROJECT_INCLUDE_SYMBOL_TABLE_H_
+#define PROJECT_INCLUDE_SYMBOL_TABLE_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <string>
+#include <vector>
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+namespace fcal {
+namespace scanner {
+
+/*******************************************************************************
+ * Class Declarations
+ ******************************************************************************/
+/*!
+ * \brief Interns identifiers as dense integer symbols.
+ *
+ * The first distinct name interned gets symbol 0, the next 1, and so
+ * on, so two identifiers are the same name exactly when their symbols
+ * are equal and symbols can index plain arrays. The names are kept so
+ * that they can be looked up again when code is emitted.
+ */
+class SymbolTable {
+ public:
+  SymbolTable(void) : names_(), hashes_(), slots_() {}
+
+  /// The symbol for the length characters at text, added if new.
+  int Intern(const char *text, int length);
+
+  /// The name a symbol was interned from.
+  const std::string &name(int symbol) const { return names_[symbol]; }
+
+  /// Forget every name, keeping the memory of the table for the names
+  /// interned next.
+  void Clear(void);
+
+  /// The number of distinct names interned so far.
+  int size(void) const { return static_cast<int>(names_.size()); }
+
+ private:
+  SymbolTable(const SymbolTable &);
+  SymbolTable &operator=(const SymbolTable &);
+
+  void Rehash(int capacity);
+
+  // names_[s] and hashes_[s] describe symbol s. slots_ is an open
+  // addressing table of symbols, -1 when empty, whose size is a power
+  // of two kept at least twice the number of symbols.
+  std::vector<std::string> names_;
+  std::vector<unsigned> hashes_;
+  std::vector<int> slots_;
+}; /* class SymbolTable */
+
+} /* namespace scanner */
+} /* namespace fcal */
+
+#endif  // PROJECT_INCLUDE_SYMBOL_TABLE_H_
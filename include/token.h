@@ -16,13 +16,17 @@ namespace scanner {
 /*******************************************************************************
  * Class Declarations
  ******************************************************************************/
+/*!
+ * A token does not own its lexeme. It points into the text that was
+ * scanned (text_, length_), so that text must outlive the token. The
+ * lexeme is only copied into a std::string when lexeme() is called.
+ */
 class Token {
     // public declarations
  public:
       // Constructor
       Token();
-      Token(std::string, TokenType, Token *);
-      Token(TokenType, std::string, Token *);
+      Token(TokenType, const char *, int, Token *);
 
       // Destructor
       ~Token();
@@ -30,17 +34,20 @@ class Token {
       // Accessors
       TokenType terminal();
       std::string lexeme();
+      const char * text();
+      int length();
       Token * next();
 
       // Mutators
       void set_terminal_(TokenType);
-      void set_lexeme_(std::string);
+      void set_lexeme_(const char *, int);
       void set_next_(Token *);
 
     // private declarations
  private:
       TokenType terminal_;
-      std::string lexeme_;
+      const char * text_;
+      int length_;
       Token * next_;
 }; /* class Token */
 } /* namespace scanner */
@@ -0,0 +1,87 @@
+#ifndef PROJECT_INCLUDE_TOKEN_SPEC_H_
+#define PROJECT_INCLUDE_TOKEN_SPEC_H_
+
+/*******************************************************************************
+ * Constant Definitions
+ ******************************************************************************/
+/*!
+ * The one description of every kind of FCAL token. Each X(...) entry
+ * gives, in order:
+ *
+ *   name        - The terminal is k<name>, and the order of the entries
+ *                 is the order of the terminals.
+ *   spelling    - The text of a keyword, punctuation mark or operator,
+ *                 or nullptr for terminals with variable text.
+ *   pattern     - The regular expression that defines the terminal.
+ *   nud         - The Parser method that parses an expression starting
+ *                 with it, or no_nud.
+ *   led         - The Parser method that parses the rest of an
+ *                 expression it follows the left operand of, or no_led.
+ *   lbp         - Its left binding power in the Pratt parser.
+ *   description - How parse errors refer to it.
+ *
+ * FCAL_TOKENS(X) expands X once per terminal. The TokenType enum, the
+ * TokenSpec table, the keyword hash, LexerTables, the nud and led
+ * tables of the Parser and the descriptions in parse errors are all
+ * generated from it, so adding a terminal is a matter of adding a line
+ * here and teaching MatchToken to lex it when it is not a keyword.
+ */
+#define FCAL_TOKENS(X) \
+  X(IntKwd,    "int",     "^int",     no_nud, no_led, 0, "'int'") \
+  X(FloatKwd,  "float",   "^float",   no_nud, no_led, 0, "'float'") \
+  X(BoolKwd,   "boolean", "^boolean", no_nud, no_led, 0, "'boolean'") \
+  X(TrueKwd,   "True",    "^True",    parse_true_kwd, no_led, 0, \
+    "true const") \
+  X(FalseKwd,  "False",   "^False",   parse_false_kwd, no_led, 0, \
+    "false const") \
+  X(StringKwd, "string",  "^string",  no_nud, no_led, 0, "'string'") \
+  X(MatrixKwd, "matrix",  "^matrix",  no_nud, no_led, 0, "'matrix'") \
+  X(LetKwd,    "let",     "^let",     parse_let_expr, no_led, 80, "'let'") \
+  X(InKwd,     "in",      "^in",      no_nud, no_led, 0, "'in'") \
+  X(EndKwd,    "end",     "^end",     no_nud, no_led, 0, "'end'") \
+  X(IfKwd,     "if",      "^if",      parse_if_expr, no_led, 80, "'if'") \
+  X(ThenKwd,   "then",    "^then",    no_nud, no_led, 0, "'then'") \
+  X(ElseKwd,   "else",    "^else",    no_nud, no_led, 0, "'else'") \
+  X(RepeatKwd, "repeat",  "^repeat",  no_nud, no_led, 0, "'repeat'") \
+  X(WhileKwd,  "while",   "^while",   no_nud, no_led, 0, "'while'") \
+  X(PrintKwd,  "print",   "^print",   no_nud, no_led, 0, "'print'") \
+  X(ToKwd,     "to",      "^to",      no_nud, no_led, 0, "'to'") \
+  /* Constants */ \
+  X(IntConst,   nullptr, "^[0-9]+", parse_int_const, no_led, 0, \
+    "int const") \
+  X(FloatConst, nullptr, "^[0-9]*\\.?[0-9]*", parse_float_const, no_led, 0, \
+    "float const") \
+  X(StringConst, nullptr, "^\"(\\.|[^\"])*\"", parse_string_const, no_led, \
+    0, "string const") \
+  /* Names */ \
+  X(VariableName, nullptr, "^[a-zA-Z_][a-zA-Z_0-9]*", parse_variable_name, \
+    no_led, 0, "variable name") \
+  /* Punctuation */ \
+  X(LeftParen,   "(", "^\\(", parse_nested_expr, no_led, 80, "'('") \
+  X(RightParen,  ")", "^)",   no_nud, no_led, 0, ")") \
+  X(LeftCurly,   "{", "^\\{", no_nud, no_led, 0, "{") \
+  X(RightCurly,  "}", "^}",   no_nud, no_led, 0, "}") \
+  X(LeftSquare,  "[", "^\\[", no_nud, no_led, 0, "[") \
+  X(RightSquare, "]", "^]",   no_nud, no_led, 0, "]") \
+  X(SemiColon,   ";", "^;",   no_nud, no_led, 0, ";") \
+  X(Colon,       ":", "^:",   no_nud, no_led, 0, ":") \
+  /* Operators */ \
+  X(Assign,       "=", "^=",   no_nud, no_led, 0, "=") \
+  X(PlusSign,     "+", "^\\+", no_nud, parse_addition, 50, "'+'") \
+  X(Star,         "*", "^\\*", no_nud, parse_multiplication, 60, "'*'") \
+  X(Dash,         "-", "^-",   no_nud, parse_subtraction, 50, "'-'") \
+  X(ForwardSlash, "/", "^/",   no_nud, parse_division, 60, "/") \
+  X(LessThan,         "<",  "^<",  no_nud, parse_relational_expr, 30, "<") \
+  X(LessThanEqual,    "<=", "^<=", no_nud, parse_relational_expr, 30, "<=") \
+  X(GreaterThan,      ">",  "^>",  no_nud, parse_relational_expr, 30, ">") \
+  X(GreaterThanEqual, ">=", "^>=", no_nud, parse_relational_expr, 30, ">=") \
+  X(EqualsEquals,     "==", "^==", no_nud, parse_relational_expr, 30, "==") \
+  X(NotEquals,        "!=", "^!=", no_nud, parse_relational_expr, 30, "!=") \
+  X(AndOp, "&&", "^&&",     no_nud, no_led, 0, "&&") \
+  X(OrOp,  "||", "^\\|\\|", no_nud, no_led, 0, "||") \
+  X(NotOp, "!",  "^!",      parse_not_expr, no_led, 0, "notOp") \
+  /* Special terminal types */ \
+  X(EndOfFile,    nullptr, "^EOF", no_nud, no_led, 0, "end of file") \
+  X(LexicalError, nullptr, "[^ ]", no_nud, no_led, 0, "lexical error")
+
+#endif  // PROJECT_INCLUDE_TOKEN_SPEC_H_
@@ -0,0 +1,129 @@
+#ifndef PROJECT_INCLUDE_TOKEN_STREAM_H_
+#define PROJECT_INCLUDE_TOKEN_STREAM_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <string>
+#include "include/iter2scanner.h"
+#include "include/symbol_table.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+namespace fcal {
+namespace scanner {
+
+/*******************************************************************************
+ * Class Declarations
+ ******************************************************************************/
+/*!
+ * \brief A scanned program stored as a struct of arrays.
+ *
+ * Token i is described by terminal(i), offset(i) and length(i); the
+ * offset is relative to the start of the scanned source, which the
+ * stream does not own. When the stream has a symbol table, each
+ * variable name is interned as it is scanned and symbol(i) is its
+ * symbol; for other tokens, or with no table, symbol(i) is -1. The
+ * columns share one heap block, so the whole stream is freed with a
+ * single deallocation and Reset() keeps the block for the next scan.
+ *
+ * The stream also remembers its first open token: one whose match read
+ * all the way to the end of the text, which is an unterminated '"' or a
+ * '/' that starts a comment that never closes. An edit anywhere after
+ * an open token can change how it is lexed.
+ */
+class TokenStream {
+ public:
+  TokenStream(void)
+      : source_(""), symbol_table_(nullptr), block_(nullptr),
+        offsets_(nullptr), lengths_(nullptr), symbols_(nullptr),
+        terminals_(nullptr), size_(0), capacity_(0), first_open_(-1) {}
+  ~TokenStream(void);
+
+  /// Empty the stream and point it at a new source text. The symbol
+  /// table, if any, is kept.
+  void Reset(const char *source);
+
+  /// Drop the first count tokens, moving the rest to the front. Their
+  /// offsets are unchanged, so a window over a long source can slide
+  /// along it without growing.
+  void Discard(int count);
+
+  /// Make room for at least capacity tokens in all.
+  void Reserve(int capacity) {
+    if (capacity > capacity_) Grow(capacity);
+  }
+
+  /// Add a token to the end of the stream.
+  void Append(TokenType terminal, int offset, int length, int symbol) {
+    if (size_ == capacity_) Grow(size_ + 1);
+    terminals_[size_] = static_cast<unsigned char>(terminal);
+    offsets_[size_] = offset;
+    lengths_[size_] = length;
+    symbols_[size_] = symbol;
+    ++size_;
+    if (terminal == kLexicalError || terminal == kForwardSlash) {
+      NoteOpen(offset);
+    }
+  }
+
+  /// Replace tokens [first, last) with the tokens of replacement, and
+  /// add shift to the offsets of the tokens from last on. The stream
+  /// then refers to the source of replacement.
+  void Splice(int first, int last, const TokenStream &replacement,
+              int shift);
+
+  int size(void) const { return size_; }
+  const char *source(void) const { return source_; }
+
+  /// The table variable names are interned into, which the stream does
+  /// not own; nullptr for none.
+  SymbolTable *symbol_table(void) const { return symbol_table_; }
+  void symbol_table(SymbolTable *table) { symbol_table_ = table; }
+
+  TokenType terminal(int i) const {
+    return static_cast<TokenType>(terminals_[i]);
+  }
+  int offset(int i) const { return offsets_[i]; }
+  int length(int i) const { return lengths_[i]; }
+  int symbol(int i) const { return symbols_[i]; }
+
+  /// The offset of the first open token, or -1 if there is none.
+  int first_open(void) const { return first_open_; }
+  const char *text(int i) const { return source_ + offsets_[i]; }
+
+  /// Copy the lexeme of token i out of the source text.
+  std::string lexeme(int i) const {
+    return std::string(source_ + offsets_[i], lengths_[i]);
+  }
+
+ private:
+  TokenStream(const TokenStream &);
+  TokenStream &operator=(const TokenStream &);
+
+  void Grow(int min_capacity);
+
+  /// Record the token at offset if it is the first open one.
+  void NoteOpen(int offset) {
+    const char *p = source_ + offset;
+    bool open = p[0] == '"' || (p[0] == '/' && (p[1] == '*' || p[1] == '/'));
+    if (open && first_open_ < 0) first_open_ = offset;
+  }
+
+  const char *source_;
+  SymbolTable *symbol_table_;
+  char *block_;
+  int *offsets_;
+  int *lengths_;
+  int *symbols_;
+  unsigned char *terminals_;
+  int size_;
+  int capacity_;
+  int first_open_;
+}; /* class TokenStream */
+
+} /* namespace scanner */
+} /* namespace fcal */
+
+#endif  // PROJECT_INCLUDE_TOKEN_STREAM_H_
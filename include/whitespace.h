@@ -0,0 +1,36 @@
+#ifndef PROJECT_INCLUDE_WHITESPACE_H_
+#define PROJECT_INCLUDE_WHITESPACE_H_
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+namespace fcal {
+namespace scanner {
+
+/*******************************************************************************
+ * Functions
+ ******************************************************************************/
+/*!
+ * SkipWhitespaceAndComments() - Count the white space ([\n\t\r ]), block
+ * comments and line comments at the start of text.
+ *
+ * This gives exactly the same answer as the regex based
+ * consume_whitespace_and_comments: a block comment ends at the first
+ * "*" "/" after its opening "/" "*" and may not contain a backslash, a
+ * line comment must end in a newline, and a comment that does not match
+ * is not skipped at all.
+ *
+ * When the compiler targets SSE2, runs of white space and the search
+ * for comment terminators are done 16 bytes at a time with aligned
+ * loads, which never read past the page holding the terminating null.
+ * Other targets use a scalar loop.
+ *
+ * RETURN:
+ *     int - The number of characters skipped.
+ */
+int SkipWhitespaceAndComments(const char *text);
+
+} /* namespace scanner */
+} /* namespace fcal */
+
+#endif  // PROJECT_INCLUDE_WHITESPACE_H_
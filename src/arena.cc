@@ -0,0 +1,62 @@
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <string.h>
+#include "include/arena.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+namespace fcal {
+namespace parser {
+
+/*******************************************************************************
+ * Constructors/Destructor
+ ******************************************************************************/
+Arena::~Arena(void) {
+  for (size_t i = 0; i < blocks_.size(); i++) {
+    delete [] blocks_[i];
+  } /* for() */
+} /* ~Arena() */
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+const char *Arena::CopyString(const char *text, int length) {
+  char *copy = static_cast<char *>(Allocate(length + 1));
+  memcpy(copy, text, length);
+  copy[length] = '\0';
+  return copy;
+} /* CopyString() */
+
+void Arena::Reset(void) {
+  used_ = 0;
+  if (blocks_.empty()) return;
+  for (size_t i = 1; i < blocks_.size(); i++) {
+    delete [] blocks_[i];
+  } /* for() */
+  blocks_.resize(1);
+  next_ = blocks_[0];
+  end_ = blocks_[0] + first_block_bytes_;
+  block_bytes_ = kFirstBlockBytes * 2;
+} /* Reset() */
+
+/*!
+ * Arena::AddBlock() - Start a new block with room for at least bytes.
+ * The free space left in the previous block is abandoned.
+ */
+void Arena::AddBlock(size_t bytes) {
+  size_t size = block_bytes_;
+  if (size < bytes) size = bytes;
+  // new[] of char is only aligned for fundamental types, which is
+  // what kAlignment asks for.
+  char *block = new char[size];
+  if (blocks_.empty()) first_block_bytes_ = size;
+  blocks_.push_back(block);
+  next_ = block;
+  end_ = block + size;
+  if (block_bytes_ < kMaxBlockBytes) block_bytes_ *= 2;
+} /* AddBlock() */
+
+} /* namespace parser */
+} /* namespace fcal */
@@ -1,4 +1,7 @@
 #include "include/ast.h"
+#include <string.h>
+#include <vector>
+#include "include/ast_serial.h"
 
 namespace fcal {
 namespace ast {
@@ -16,36 +19,18 @@ std::string Root::CppCode() {
   + varName_->CppCode() + " () {\n" + stmts_->CppCode() + "\n}\n";
 }
 
-/// Root Destructor
-Root::~Root() {
-  if (varName_) {delete varName_;}
-  if (stmts_) {delete stmts_;}
+/// Unparse a block of statements
+std::string StmtsBlock::unparse() {
+  std::string text;
+  for (int i = 0; i < count_; i++) text += stmts_[i]->unparse();
+  return text;
 }
 
-// StmtsSeq destructor
-StmtsSeq::~StmtsSeq() {
-  if (stmt_) {delete stmt_;}
-  if (stmts_) {delete stmts_;}
-}
-
-/// Unparse a sequence of statements
-std::string StmtsSeq::unparse() {
-  return stmt_->unparse() + stmts_->unparse();
-}
-
-/// Translate a seqence of statements to C++ code
-std::string StmtsSeq::CppCode() {
-  return stmt_->CppCode() + stmts_->CppCode();
-}
-
-/// Unparse an empty statement (->empty string)
-std::string EmptyStmts::unparse() {
-  return "";
-}
-
-/// Translate an empty statement to C++ code (->empty string)
-std::string EmptyStmts::CppCode() {
-  return "";
+/// Translate a block of statements to C++ code
+std::string StmtsBlock::CppCode() {
+  std::string code;
+  for (int i = 0; i < count_; i++) code += stmts_[i]->CppCode();
+  return code;
 }
 
 /// Unparse a declaration
@@ -54,12 +39,6 @@ std::string DeclStmt::unparse() { return decl_->unparse(); }
 /// Translate a declaration to C++ code
 std::string DeclStmt::CppCode() { return decl_->CppCode(); }
 
-/// Assignment statement destructor
-AssignStmt::~AssignStmt() {
-  if (varName_) { delete varName_; }
-  if (expr_)    { delete expr_; }
-}
-
 /// Unparse an assignment statement
 std::string AssignStmt::unparse() {
   return varName_->unparse() + " = " + expr_->unparse() + ";\n";
@@ -70,14 +49,6 @@ std::string AssignStmt::CppCode() {
   return varName_->CppCode() + " = " + expr_->CppCode() + ";\n";
 }
 
-/// Matrix statement assignment destructor
-AssignMatrixStmt::~AssignMatrixStmt() {
-  if (varName_) {delete varName_;}
-  if (expr1_) {delete expr1_;}
-  if (expr2_) {delete expr2_;}
-  if (expr3_) {delete expr3_;}
-}
-
 /// Unparse a matrix assignment statement
 std::string AssignMatrixStmt::unparse() {
   return varName_->unparse() + " [" + expr1_->unparse() + " : " +
@@ -91,11 +62,6 @@ std::string AssignMatrixStmt::CppCode() {
          ", " + expr2_->CppCode() + ")) = " + expr3_->CppCode() + ";\n";
 }
 
-/// Destructor for PrintStmt
-PrintStmt::~PrintStmt() {
-  if (expr_) {delete expr_;}
-}
-
 /// Unparse a print statement
 std::string PrintStmt::unparse() {
   return "print(" + expr_->unparse() + ");\n";
@@ -106,12 +72,6 @@ std::string PrintStmt::CppCode() {
   return "cout << " + expr_->CppCode() + ";\n";
 }
 
-/// Destructor for IfStmt
-IfStmt::~IfStmt() {
-  if (expr_) {delete expr_;}
-  if (stmt_) {delete stmt_;}
-}
-
 /// Unparse an if statement
 std::string IfStmt::unparse() {
   return "if (" + expr_->unparse() + ") " + stmt_->unparse();
@@ -122,13 +82,6 @@ std::string IfStmt::CppCode() {
   return "if (" + expr_->CppCode() + ")\n" + stmt_->CppCode();
 }
 
-/// Destructor for an if else statement
-IfElseStmt::~IfElseStmt() {
-  if (expr_) {delete expr_;}
-  if (stmt1_) {delete stmt1_;}
-  if (stmt2_) {delete stmt2_;}
-}
-
 /// Unparse an if else statement
 std::string IfElseStmt::unparse() {
   return "if (" + expr_->unparse() + ") " +
@@ -141,34 +94,18 @@ std::string IfElseStmt::CppCode() {
          "\nelse\n" + stmt2_->unparse();
 }
 
-/// Destructor for StmtsStmt
-StmtsStmt::~StmtsStmt() {
-  if (stmts_) {delete stmts_;}
-}
-
 /// Unparse a Statement to statement
 std::string StmtsStmt::unparse() { return "{\n" + stmts_->unparse() + "}\n";}
 
 /// Translate a statement to statement to C++ code
 std::string StmtsStmt::CppCode() { return  "{\n" + stmts_->CppCode() + "}\n";}
 
-/// Destructor for a semicolon statement
-SemiColonStmt::~SemiColonStmt() {}
-
 /// Unparse a semicolon statement
 std::string SemiColonStmt::unparse() { return ";\n";}
 
 /// Translate a semicolon to C++ code
 std::string SemiColonStmt::CppCode() { return ";\n";}
 
-/// Destructor for RepeatStmt
-RepeatStmt::~RepeatStmt() {
-  if (varName_) {delete varName_;}
-  if (expr1_) {delete expr1_;}
-  if (expr2_) {delete expr2_;}
-  if (stmt_) {delete stmt_;}
-}
-
 /// Unparse a repeat statement
 std::string RepeatStmt::unparse() {
     return "repeat (" + varName_->unparse() + " = " +
@@ -184,12 +121,6 @@ std::string RepeatStmt::CppCode() {
          "++) " + stmt_->CppCode() + "\n";
 }
 
-/// destructor for a while statement
-WhileStmt::~WhileStmt() {
-  if (expr_) {delete expr_;}
-  if (stmt_) {delete stmt_;}
-}
-
 /// Unparse a while statement
 std::string WhileStmt::unparse() {
   return "while (" + expr_->unparse() + ") " + stmt_->unparse();
@@ -200,48 +131,28 @@ std::string WhileStmt::CppCode() {
   return "while (" + expr_->CppCode() + ")\n" + stmt_->CppCode();
 }
 
-/// SimpleDecl destructor
-SimpleDecl::~SimpleDecl() {
-  if (kwdType_) {delete kwdType_;}
-  if (varName_) {delete varName_;}
-}
-
 /// Unparse a simple declaration
 std::string SimpleDecl::unparse() {
-  return *kwdType_ + " " + varName_->unparse() + ";\n";
+  return std::string(kwdType_) + " " + varName_->unparse() + ";\n";
 }
 
 /// Translate a simple declaration to C++ code
 std::string SimpleDecl::CppCode() {
-  std::string* str = nullptr;
-  std::string Int("int");
-  std::string Float("float");
-  std::string String("string");
-  std::string Bool("boolean");
-
-  if (kwdType_->compare(Int) == 0) {
-    str = new std::string("int");
-  } else if (kwdType_->compare(Float) == 0) {
-    str = new std::string("float");
-  } else if (kwdType_->compare(String) == 0) {
-    str = new std::string("string");
-  } else if (kwdType_->compare(Bool) == 0) {
-    str = new std::string("bool");
+  const char *str = nullptr;
+
+  if (strcmp(kwdType_, "int") == 0) {
+    str = "int";
+  } else if (strcmp(kwdType_, "float") == 0) {
+    str = "float";
+  } else if (strcmp(kwdType_, "string") == 0) {
+    str = "string";
+  } else if (strcmp(kwdType_, "boolean") == 0) {
+    str = "bool";
   } else {
     throw "no match on SimpleDecl";
   }
 
-  return *str + " " + varName_->CppCode() + ";\n";
-}
-
-/// Destructor for LongMatrixDecl
-LongMatrixDecl::~LongMatrixDecl() {
-  if (var1_) {delete var1_;}
-  if (expr1_) {delete expr1_;}
-  if (expr2_) {delete expr2_;}
-  if (var2_) {delete var2_;}
-  if (var3_) {delete var3_;}
-  if (expr3_) {delete expr3_;}
+  return std::string(str) + " " + varName_->CppCode() + ";\n";
 }
 
 /// Unparse a long matrix declaration
@@ -271,12 +182,6 @@ std::string LongMatrixDecl::CppCode() {
   return matrixDecl + forStmt;
 }
 
-/// Destructor for ShortMatrixDecl
-ShortMatrixDecl::~ShortMatrixDecl() {
-  if (varName_) {delete varName_;}
-  if (expr_) {delete expr_;}
-}
-
 /// Unparse a short matrix declarattion
 std::string ShortMatrixDecl::unparse() {
   return "matrix " + varName_->unparse() + " = " + expr_->unparse() + ";\n";
@@ -288,12 +193,6 @@ std::string ShortMatrixDecl::CppCode() {
 }
 
 // Expr
-/// LetExpr destructor
-LetExpr::~LetExpr() {
-  if (stmts_) {delete stmts_;}
-  if (expr_) {delete expr_;}
-}
-
 /// Unparse a let expression
 std::string LetExpr::unparse() {
   return "let " + stmts_->unparse() + " in " + expr_->unparse() + " end";
@@ -304,28 +203,36 @@ std::string LetExpr::CppCode() {
   return "({ " + stmts_->CppCode() + "(" + expr_->CppCode() + "); });\n";
 }
 
-/// Destructor for BinOpExpr
-BinOpExpr::~BinOpExpr() {
-  if (left_) {delete left_;}
-  if (operator_) {delete operator_;}
-  if (right_) {delete right_;}
-}
-
 /// Unparse a binary operation expression
-std::string BinOpExpr::unparse() {
-  return left_->unparse() + " " + *operator_ + " " + right_->unparse();
-}
+std::string BinOpExpr::unparse() { return Emit(&Expr::unparse); }
 
 /// Translate a binary operation expression to C++ code
-std::string BinOpExpr::CppCode() {
-  return left_->CppCode() + " " + *operator_ + " " + right_->CppCode();
-}
-
-/// Destructor for a function expression
-FunctionExpr::~FunctionExpr() {
-  if (varName_) {delete varName_;}
-  if (expr_) {delete expr_;}
-}
+std::string BinOpExpr::CppCode() { return Emit(&Expr::CppCode); }
+
+/*!
+ * BinOpExpr::Emit() - Emit the chain of operators down the left spine
+ * of this expression with emit, leftmost operand first. Only the right
+ * operands, which bind tighter, are emitted by recursion.
+ */
+std::string BinOpExpr::Emit(std::string (Expr::*emit)()) {
+  std::vector<BinOpExpr *> spine;
+  BinOpExpr *node = this;
+  for (;;) {
+    spine.push_back(node);
+    BinOpExpr *left = node->left_->AsBinOp();
+    if (left == nullptr) break;
+    node = left;
+  } /* for() */
+
+  std::string text = (node->left_->*emit)();
+  for (size_t i = spine.size(); i-- > 0;) {
+    text += " ";
+    text += spine[i]->operator_;
+    text += " ";
+    text += (spine[i]->right_->*emit)();
+  } /* for() */
+  return text;
+} /* BinOpExpr::Emit() */
 
 /// Unparse a function expression
 std::string FunctionExpr::unparse() {
@@ -347,13 +254,6 @@ std::string FunctionExpr::CppCode() {
   }
 }
 
-/// Destructor for MatrixExpr
-MatrixExpr::~MatrixExpr() {
-  if (varName_) {delete varName_;}
-  if (expr1_) {delete expr1_;}
-  if (expr2_) {delete expr2_;}
-}
-
 /// Unparse a matrix expression
 std::string MatrixExpr::unparse() {
   return varName_->unparse() + " [" + expr1_->unparse() + ": " +
@@ -367,13 +267,6 @@ std::string MatrixExpr::CppCode() {
          expr2_->CppCode() + "))";
 }
 
-/// Destructor for IfExpr
-IfExpr::~IfExpr() {
-  if (expr1_) {delete expr1_;}
-  if (expr2_) {delete expr2_;}
-  if (expr3_) {delete expr3_;}
-}
-
 /// Unparse and if expression
 std::string IfExpr::unparse() {
   return "if " + expr1_->unparse() + " then " + expr2_->unparse() + " else "
@@ -386,38 +279,23 @@ std::string IfExpr::CppCode() {
          expr3_->CppCode();
 }
 
-/// Destructor for ParenExpr
-ParenExpr::~ParenExpr() {
-  if (expr_) {delete expr_;}
-}
-
 /// Unparse a ParenExpr
 std::string ParenExpr::unparse() { return "(" + expr_->unparse() + ")";}
 
 /// Translate a ParenExpr to C++ code
 std::string ParenExpr::CppCode() { return "(" + expr_->CppCode() + ")";}
 
-/// Unparse a VarName (return the lexeme)
-std::string VarName::unparse() { return lexeme_; }
+/// Unparse a VarName (return the interned name)
+std::string VarName::unparse() { return symbols_->name(symbol_); }
 
-/// Translate a VarName to C++ code (return the lexeme)
-std::string VarName::CppCode() { return lexeme_; }
-
-/// Destructor for AnyConst
-AnyConst::~AnyConst() {
-  if (constStr_) {delete constStr_;}
-}
+/// Translate a VarName to C++ code (return the interned name)
+std::string VarName::CppCode() { return symbols_->name(symbol_); }
 
 /// Unparse AnyConst (return the constant)
-std::string AnyConst::unparse() { return *constStr_; }
+std::string AnyConst::unparse() { return constStr_; }
 
 /// Translate AnyConst to C++ code (return the constant)
-std::string AnyConst::CppCode() { return *constStr_;}
-
-/// Destructor for a not expression
-NotExpr::~NotExpr() {
-  if (expr_) {delete expr_;}
-}
+std::string AnyConst::CppCode() { return constStr_;}
 
 /// Unparse a not expression
 std::string NotExpr::unparse () { return "!" + expr_->unparse(); }
@@ -425,23 +303,217 @@ std::string NotExpr::unparse () { return "!" + expr_->unparse(); }
 /// Translate a not expression to C++ code
 std::string NotExpr::CppCode() { return "!" + expr_->CppCode(); }
 
-/// Destructor for TrueKwdExpr
-TrueKwdExpr::~TrueKwdExpr() {}
-
 /// Unparse a TrueKwdExpre (return "True")
 std::string TrueKwdExpr::unparse() { return "True";}
 
 /// Translate a TrueKwdExpr to C++ code (return "true")
 std::string TrueKwdExpr::CppCode() { return "true";}
 
-/// Destructor for FalseKwdExpr
-FalseKwdExpr::~FalseKwdExpr() {}
-
 /// Unparse a FalseKwdExpre (return "False")
 std::string FalseKwdExpr::unparse() { return "False";}
 
 /// Translate a FalseKwdExpr to C++ code (return "false")
 std::string FalseKwdExpr::CppCode() { return "false";}
 
+/*
+ * Saving trees
+ * ------------
+ * Each node saves its children in the order its constructor takes
+ * them, then its tag and any other fields; see AstWriter.
+ */
+
+/// Save the root (program)
+void Root::Save(AstWriter *out) {
+  out->Save(varName_);
+  out->Save(stmts_);
+  out->Tag(kRootNode);
+  out->Int(body_);
+}
+
+/// Save a block of statements
+void StmtsBlock::Save(AstWriter *out) {
+  for (int i = 0; i < count_; i++) out->Save(stmts_[i]);
+  out->Tag(kStmtsBlockNode);
+  out->Int(count_);
+  for (int i = 0; i <= count_; i++) out->Int(starts_[i]);
+}
+
+/// Save a declaration statement
+void DeclStmt::Save(AstWriter *out) {
+  out->Save(decl_);
+  out->Tag(kDeclStmtNode);
+}
+
+/// Save an assignment statement
+void AssignStmt::Save(AstWriter *out) {
+  out->Save(varName_);
+  out->Save(expr_);
+  out->Tag(kAssignStmtNode);
+}
+
+/// Save a matrix assignment statement
+void AssignMatrixStmt::Save(AstWriter *out) {
+  out->Save(varName_);
+  out->Save(expr1_);
+  out->Save(expr2_);
+  out->Save(expr3_);
+  out->Tag(kAssignMatrixStmtNode);
+}
+
+/// Save a print statement
+void PrintStmt::Save(AstWriter *out) {
+  out->Save(expr_);
+  out->Tag(kPrintStmtNode);
+}
+
+/// Save an if statement
+void IfStmt::Save(AstWriter *out) {
+  out->Save(expr_);
+  out->Save(stmt_);
+  out->Tag(kIfStmtNode);
+}
+
+/// Save an if else statement
+void IfElseStmt::Save(AstWriter *out) {
+  out->Save(expr_);
+  out->Save(stmt1_);
+  out->Save(stmt2_);
+  out->Tag(kIfElseStmtNode);
+}
+
+/// Save a statement to statements
+void StmtsStmt::Save(AstWriter *out) {
+  out->Save(stmts_);
+  out->Tag(kStmtsStmtNode);
+}
+
+/// Save a semicolon statement
+void SemiColonStmt::Save(AstWriter *out) { out->Tag(kSemiColonStmtNode); }
+
+/// Save a repeat statement
+void RepeatStmt::Save(AstWriter *out) {
+  out->Save(varName_);
+  out->Save(expr1_);
+  out->Save(expr2_);
+  out->Save(stmt_);
+  out->Tag(kRepeatStmtNode);
+}
+
+/// Save a while statement
+void WhileStmt::Save(AstWriter *out) {
+  out->Save(expr_);
+  out->Save(stmt_);
+  out->Tag(kWhileStmtNode);
+}
+
+/// Save a simple declaration
+void SimpleDecl::Save(AstWriter *out) {
+  out->Save(varName_);
+  out->Tag(kSimpleDeclNode);
+  out->Spelling(kwdType_);
+}
+
+/// Save a long matrix declaration
+void LongMatrixDecl::Save(AstWriter *out) {
+  out->Save(var1_);
+  out->Save(expr1_);
+  out->Save(expr2_);
+  out->Save(var2_);
+  out->Save(var3_);
+  out->Save(expr3_);
+  out->Tag(kLongMatrixDeclNode);
+}
+
+/// Save a short matrix declaration
+void ShortMatrixDecl::Save(AstWriter *out) {
+  out->Save(varName_);
+  out->Save(expr_);
+  out->Tag(kShortMatrixDeclNode);
+}
+
+/// Save a let expression
+void LetExpr::Save(AstWriter *out) {
+  out->Save(stmts_);
+  out->Save(expr_);
+  out->Tag(kLetExprNode);
+}
+
+/*!
+ * BinOpExpr::Save() - Save the chain of operators down the left spine
+ * of this expression in a loop, like Emit. In post order the leftmost
+ * operand comes first, then each right operand and its operator from
+ * the bottom of the spine up.
+ */
+void BinOpExpr::Save(AstWriter *out) {
+  std::vector<BinOpExpr *> spine;
+  BinOpExpr *node = this;
+  for (;;) {
+    spine.push_back(node);
+    BinOpExpr *left = node->left_ ? node->left_->AsBinOp() : nullptr;
+    if (left == nullptr) break;
+    node = left;
+  } /* for() */
+
+  out->Save(node->left_);
+  for (size_t i = spine.size(); i-- > 0;) {
+    out->Save(spine[i]->right_);
+    out->Tag(kBinOpExprNode);
+    out->Spelling(spine[i]->operator_);
+  } /* for() */
+} /* BinOpExpr::Save() */
+
+/// Save a function expression
+void FunctionExpr::Save(AstWriter *out) {
+  out->Save(varName_);
+  out->Save(expr_);
+  out->Tag(kFunctionExprNode);
+}
+
+/// Save a matrix expression
+void MatrixExpr::Save(AstWriter *out) {
+  out->Save(varName_);
+  out->Save(expr1_);
+  out->Save(expr2_);
+  out->Tag(kMatrixExprNode);
+}
+
+/// Save an if expression
+void IfExpr::Save(AstWriter *out) {
+  out->Save(expr1_);
+  out->Save(expr2_);
+  out->Save(expr3_);
+  out->Tag(kIfExprNode);
+}
+
+/// Save a ParenExpr
+void ParenExpr::Save(AstWriter *out) {
+  out->Save(expr_);
+  out->Tag(kParenExprNode);
+}
+
+/// Save a VarName (its symbol)
+void VarName::Save(AstWriter *out) {
+  out->Tag(kVarNameNode);
+  out->Int(symbol_);
+}
+
+/// Save AnyConst (its text)
+void AnyConst::Save(AstWriter *out) {
+  out->Tag(kAnyConstNode);
+  out->String(constStr_);
+}
+
+/// Save a not expression
+void NotExpr::Save(AstWriter *out) {
+  out->Save(expr_);
+  out->Tag(kNotExprNode);
+}
+
+/// Save a TrueKwdExpr
+void TrueKwdExpr::Save(AstWriter *out) { out->Tag(kTrueKwdExprNode); }
+
+/// Save a FalseKwdExpr
+void FalseKwdExpr::Save(AstWriter *out) { out->Tag(kFalseKwdExprNode); }
+
 } /* namespace ast */
 } /* namespace fcal */
@@ -0,0 +1,206 @@
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include <memory>
+#include "include/ast_cache.h"
+#include "include/ast_serial.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+namespace fcal {
+namespace parser {
+
+/*******************************************************************************
+ * Constant Definitions
+ ******************************************************************************/
+/// The first bytes of every entry.
+static const char kMagic[8] = "FCALAST";
+
+/// The start of an entry. It is followed by the text_size characters
+/// of the text, num_names names, each an int length and its characters,
+/// and then tree_bytes of saved tree.
+struct EntryHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t num_names;
+  uint64_t text_size;
+  uint64_t text_hash;
+  uint64_t tree_bytes;
+};
+
+/*******************************************************************************
+ * Helper Functions
+ ******************************************************************************/
+/// FNV-1a hash of kVersion followed by the size characters at text.
+static uint64_t HashText(const char *text, size_t size) {
+  uint64_t hash = 14695981039346656037ull;
+  uint32_t version = AstCache::kVersion;
+  const unsigned char *bytes =
+      reinterpret_cast<const unsigned char *>(&version);
+  for (size_t i = 0; i < sizeof(version); i++) {
+    hash ^= bytes[i];
+    hash *= 1099511628211ull;
+  } /* for() */
+  bytes = reinterpret_cast<const unsigned char *>(text);
+  for (size_t i = 0; i < size; i++) {
+    hash ^= bytes[i];
+    hash *= 1099511628211ull;
+  } /* for() */
+  return hash;
+} /* HashText() */
+
+/// Write all size bytes at data to fd.
+static bool WriteAll(int fd, const char *data, size_t size) {
+  while (size > 0) {
+    ssize_t written = write(fd, data, size);
+    if (written <= 0) return false;
+    data += written;
+    size -= written;
+  } /* while() */
+  return true;
+} /* WriteAll() */
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+ParseResult AstCache::Parse(Parser *parser, const char *text) {
+  size_t size = strlen(text);
+  uint64_t hash = HashText(text, size);
+
+  ParseResult pr;
+  if (Load(text, hash, size, &pr)) return pr;
+
+  pr = parser->Parse(text);
+  if (pr.ok()) Store(text, hash, size, &pr);
+  return pr;
+} /* Parse() */
+
+bool AstCache::Load(const char *text, ParseResult *pr) {
+  size_t size = strlen(text);
+  return Load(text, HashText(text, size), size, pr);
+} /* Load() */
+
+std::string AstCache::Path(uint64_t hash) {
+  char name[32];
+  snprintf(name, sizeof(name), "/%016llx.ast",
+           static_cast<unsigned long long>(hash));
+  return dir_ + name;
+} /* Path() */
+
+/*!
+ * AstCache::Load() - Map the entry for text, of the given hash and
+ * size, and rebuild its tree, with a new symbol table and arena, into
+ * pr. The hash only names the entry: a different text of the same size
+ * can have the same hash, so the entry is only used if the text saved
+ * in it is text. The names and constants are copied out, so the
+ * mapping is gone by the time Load returns.
+ */
+bool AstCache::Load(const char *text, uint64_t hash, size_t size,
+                    ParseResult *pr) {
+  int fd = open(Path(hash).c_str(), O_RDONLY);
+  if (fd < 0) return false;
+  struct stat filestatus;
+  if (fstat(fd, &filestatus) != 0 ||
+      static_cast<size_t>(filestatus.st_size) < sizeof(EntryHeader)) {
+    close(fd);
+    return false;
+  }
+  size_t length = filestatus.st_size;
+  void *mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED) return false;
+
+  const char *data = static_cast<const char *>(mapping);
+  const char *end = data + length;
+  EntryHeader header;
+  memcpy(&header, data, sizeof(header));
+  const char *next = data + sizeof(header);
+  bool ok = memcmp(header.magic, kMagic, sizeof(kMagic)) == 0 &&
+            header.version == kVersion && header.text_size == size &&
+            header.text_hash == hash &&
+            static_cast<size_t>(end - next) >= size &&
+            memcmp(next, text, size) == 0;
+  if (ok) next += size;
+
+  std::shared_ptr<scanner::SymbolTable> symbols =
+      std::make_shared<scanner::SymbolTable>();
+  for (uint32_t i = 0; ok && i < header.num_names; i++) {
+    int name_length;
+    ok = end - next >= static_cast<ptrdiff_t>(sizeof(name_length));
+    if (!ok) break;
+    memcpy(&name_length, next, sizeof(name_length));
+    next += sizeof(name_length);
+    ok = name_length >= 0 && end - next >= name_length &&
+         symbols->Intern(next, name_length) == static_cast<int>(i);
+    next += name_length;
+  } /* for() */
+
+  std::shared_ptr<Arena> arena = std::make_shared<Arena>();
+  ast::Root *tree = nullptr;
+  if (ok && header.tree_bytes == static_cast<uint64_t>(end - next)) {
+    tree = ast::LoadTree(next, end - next, arena.get(), symbols.get());
+  }
+  munmap(mapping, length);
+  if (tree == nullptr) return false;
+
+  pr->ok(true);
+  pr->errors("");
+  pr->ast(tree);
+  pr->symbols(symbols);
+  pr->arena(arena);
+  pr->tree_bytes(arena->used());
+  return true;
+} /* Load() */
+
+/*!
+ * AstCache::Store() - Save text, of the given hash and size, and the
+ * tree and symbol table of pr as the entry for text. The entry is
+ * written to a temporary file which is then renamed over the entry, so
+ * a reader never sees half of one.
+ */
+bool AstCache::Store(const char *text, uint64_t hash, size_t size,
+                     ParseResult *pr) {
+  ast::AstWriter writer;
+  writer.Save(pr->ast());
+
+  const scanner::SymbolTable &symbols = *pr->symbols();
+  EntryHeader header;
+  memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.num_names = symbols.size();
+  header.text_size = size;
+  header.text_hash = hash;
+  header.tree_bytes = writer.bytes().size();
+
+  std::string entry(reinterpret_cast<const char *>(&header), sizeof(header));
+  entry.append(text, size);
+  for (int i = 0; i < symbols.size(); i++) {
+    int name_length = static_cast<int>(symbols.name(i).size());
+    entry.append(reinterpret_cast<const char *>(&name_length),
+                 sizeof(name_length));
+    entry += symbols.name(i);
+  } /* for() */
+  entry += writer.bytes();
+
+  std::string path = Path(hash);
+  std::string temp = path + ".XXXXXX";
+  int fd = mkstemp(&temp[0]);
+  if (fd < 0) return false;
+  bool ok = WriteAll(fd, entry.data(), entry.size());
+  ok = close(fd) == 0 && ok;
+  ok = ok && rename(temp.c_str(), path.c_str()) == 0;
+  if (!ok) unlink(temp.c_str());
+  return ok;
+} /* Store() */
+
+} /* namespace parser */
+} /* namespace fcal */
@@ -0,0 +1,362 @@
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <string.h>
+#include <vector>
+#include "include/ast_serial.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+namespace fcal {
+namespace ast {
+
+/*******************************************************************************
+ * Constant Definitions
+ ******************************************************************************/
+/// What a node on the stack of LoadTree stands for in the grammar.
+/// VarNames are also Exprs, and a missing child can stand for any.
+enum NodeClass {
+  kNullClass,
+  kRootClass,
+  kStmtsClass,
+  kStmtClass,
+  kDeclClass,
+  kExprClass,
+  kVarNameClass
+};
+
+/*******************************************************************************
+ * Class Declarations
+ ******************************************************************************/
+/*!
+ * \brief The state of one call to LoadTree.
+ *
+ * Each tag pops the children of its node off stack_, checking that
+ * they are of the classes its constructor takes, and pushes the node.
+ */
+class TreeLoader {
+ public:
+  TreeLoader(const char *data, size_t size, parser::Arena *arena,
+             const scanner::SymbolTable *symbols)
+      : next_(data), end_(data + size), arena_(arena), symbols_(symbols),
+        stack_() {}
+
+  Root *Load(void);
+
+ private:
+  struct Entry {
+    Node *node;
+    NodeClass node_class;
+  };
+
+  bool Build(NodeKind kind);
+  bool ReadInt(int *value);
+  bool ReadString(const char **text);
+  bool ReadSpelling(const char **spelling);
+
+  void Push(Node *node, NodeClass node_class) {
+    Entry entry = {node, node_class};
+    stack_.push_back(entry);
+  }
+
+  /// Pop a node of class node_class, or a missing one, into node.
+  template <class T>
+  bool Pop(NodeClass node_class, T **node) {
+    if (stack_.empty()) return false;
+    Entry entry = stack_.back();
+    stack_.pop_back();
+    if (entry.node_class != kNullClass && entry.node_class != node_class &&
+        !(node_class == kExprClass && entry.node_class == kVarNameClass)) {
+      return false;
+    }
+    *node = static_cast<T *>(entry.node);
+    return true;
+  }
+
+  const char *next_;
+  const char *end_;
+  parser::Arena *arena_;
+  const scanner::SymbolTable *symbols_;
+  std::vector<Entry> stack_;
+}; /* class TreeLoader */
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+void AstWriter::Int(int value) {
+  bytes_.append(reinterpret_cast<const char *>(&value), sizeof(value));
+} /* Int() */
+
+void AstWriter::String(const char *text) {
+  int length = static_cast<int>(strlen(text));
+  Int(length);
+  bytes_.append(text, length);
+} /* String() */
+
+/*!
+ * AstWriter::Spelling() - Save the terminal spelled spelling. Spellings
+ * are compared as strings, since each translation unit may have its own
+ * copy of kTokenSpecs.
+ */
+void AstWriter::Spelling(const char *spelling) {
+  int terminal = 0;
+  while (terminal < scanner::kNumTerminals &&
+         (scanner::kTokenSpecs[terminal].spelling == nullptr ||
+          strcmp(scanner::kTokenSpecs[terminal].spelling, spelling) != 0)) {
+    terminal++;
+  } /* while() */
+  // An unknown spelling is saved as kNumTerminals, which LoadTree
+  // rejects.
+  bytes_ += static_cast<char>(terminal);
+} /* Spelling() */
+
+/*!
+ * TreeLoader::Load() - Build every node, and return the one left on the
+ * stack. Parts of a program can be saved too, but only a whole one is
+ * loaded, since the tree goes into a ParseResult, whose users take it
+ * to be a Root.
+ */
+Root *TreeLoader::Load(void) {
+  while (next_ < end_) {
+    unsigned char kind = static_cast<unsigned char>(*next_++);
+    if (kind >= kNumNodeKinds) return nullptr;
+    if (!Build(static_cast<NodeKind>(kind))) return nullptr;
+  } /* while() */
+  if (stack_.size() != 1 || stack_[0].node_class != kRootClass) {
+    return nullptr;
+  }
+  return static_cast<Root *>(stack_[0].node);
+} /* Load() */
+
+bool TreeLoader::ReadInt(int *value) {
+  if (static_cast<size_t>(end_ - next_) < sizeof(*value)) return false;
+  memcpy(value, next_, sizeof(*value));
+  next_ += sizeof(*value);
+  return true;
+} /* ReadInt() */
+
+bool TreeLoader::ReadString(const char **text) {
+  int length;
+  if (!ReadInt(&length) || length < 0 || end_ - next_ < length) return false;
+  *text = arena_->CopyString(next_, length);
+  next_ += length;
+  return true;
+} /* ReadString() */
+
+bool TreeLoader::ReadSpelling(const char **spelling) {
+  if (next_ == end_) return false;
+  int terminal = static_cast<unsigned char>(*next_++);
+  if (terminal >= scanner::kNumTerminals) return false;
+  *spelling = scanner::kTokenSpecs[terminal].spelling;
+  return *spelling != nullptr;
+} /* ReadSpelling() */
+
+/*!
+ * TreeLoader::Build() - Read the fields of a node of the given kind,
+ * take its children off the stack, last first, and push the node.
+ */
+bool TreeLoader::Build(NodeKind kind) {
+  VarName *var, *var2, *var3;
+  Expr *expr, *expr2, *expr3;
+  Stmt *stmt, *stmt2;
+  Stmts *stmts;
+  Decl *decl;
+  const char *text;
+
+  switch (kind) {
+    case kNullNode:
+      Push(nullptr, kNullClass);
+      return true;
+
+    case kRootNode: {
+      int body;
+      if (!ReadInt(&body) || !Pop(kStmtsClass, &stmts) ||
+          !Pop(kVarNameClass, &var)) {
+        return false;
+      }
+      Push(arena_->New<Root>(var, stmts, body), kRootClass);
+      return true;
+    }
+
+    case kStmtsBlockNode: {
+      int count;
+      if (!ReadInt(&count) || count < 0 ||
+          static_cast<size_t>(count) > stack_.size()) {
+        return false;
+      }
+      int *starts =
+          static_cast<int *>(arena_->Allocate(sizeof(int) * (count + 1)));
+      for (int i = 0; i <= count; i++) {
+        if (!ReadInt(&starts[i])) return false;
+      } /* for() */
+      Stmt **items =
+          static_cast<Stmt **>(arena_->Allocate(sizeof(Stmt *) * count));
+      for (int i = count - 1; i >= 0; i--) {
+        if (!Pop(kStmtClass, &items[i])) return false;
+      } /* for() */
+      Push(arena_->New<StmtsBlock>(items, count, starts), kStmtsClass);
+      return true;
+    }
+
+    case kDeclStmtNode:
+      if (!Pop(kDeclClass, &decl)) return false;
+      Push(arena_->New<DeclStmt>(decl), kStmtClass);
+      return true;
+
+    case kAssignStmtNode:
+      if (!Pop(kExprClass, &expr) || !Pop(kVarNameClass, &var)) return false;
+      Push(arena_->New<AssignStmt>(var, expr), kStmtClass);
+      return true;
+
+    case kAssignMatrixStmtNode:
+      if (!Pop(kExprClass, &expr3) || !Pop(kExprClass, &expr2) ||
+          !Pop(kExprClass, &expr) || !Pop(kVarNameClass, &var)) {
+        return false;
+      }
+      Push(arena_->New<AssignMatrixStmt>(var, expr, expr2, expr3),
+           kStmtClass);
+      return true;
+
+    case kPrintStmtNode:
+      if (!Pop(kExprClass, &expr)) return false;
+      Push(arena_->New<PrintStmt>(expr), kStmtClass);
+      return true;
+
+    case kIfStmtNode:
+      if (!Pop(kStmtClass, &stmt) || !Pop(kExprClass, &expr)) return false;
+      Push(arena_->New<IfStmt>(expr, stmt), kStmtClass);
+      return true;
+
+    case kIfElseStmtNode:
+      if (!Pop(kStmtClass, &stmt2) || !Pop(kStmtClass, &stmt) ||
+          !Pop(kExprClass, &expr)) {
+        return false;
+      }
+      Push(arena_->New<IfElseStmt>(expr, stmt, stmt2), kStmtClass);
+      return true;
+
+    case kStmtsStmtNode:
+      if (!Pop(kStmtsClass, &stmts)) return false;
+      Push(arena_->New<StmtsStmt>(stmts), kStmtClass);
+      return true;
+
+    case kSemiColonStmtNode:
+      Push(arena_->New<SemiColonStmt>(), kStmtClass);
+      return true;
+
+    case kRepeatStmtNode:
+      if (!Pop(kStmtClass, &stmt) || !Pop(kExprClass, &expr2) ||
+          !Pop(kExprClass, &expr) || !Pop(kVarNameClass, &var)) {
+        return false;
+      }
+      Push(arena_->New<RepeatStmt>(var, expr, expr2, stmt), kStmtClass);
+      return true;
+
+    case kWhileStmtNode:
+      if (!Pop(kStmtClass, &stmt) || !Pop(kExprClass, &expr)) return false;
+      Push(arena_->New<WhileStmt>(expr, stmt), kStmtClass);
+      return true;
+
+    case kSimpleDeclNode:
+      if (!ReadSpelling(&text) || !Pop(kVarNameClass, &var)) return false;
+      Push(arena_->New<SimpleDecl>(text, var), kDeclClass);
+      return true;
+
+    case kLongMatrixDeclNode:
+      if (!Pop(kExprClass, &expr3) || !Pop(kVarNameClass, &var3) ||
+          !Pop(kVarNameClass, &var2) || !Pop(kExprClass, &expr2) ||
+          !Pop(kExprClass, &expr) || !Pop(kVarNameClass, &var)) {
+        return false;
+      }
+      Push(arena_->New<LongMatrixDecl>(var, expr, expr2, var2, var3, expr3),
+           kDeclClass);
+      return true;
+
+    case kShortMatrixDeclNode:
+      if (!Pop(kExprClass, &expr) || !Pop(kVarNameClass, &var)) return false;
+      Push(arena_->New<ShortMatrixDecl>(var, expr), kDeclClass);
+      return true;
+
+    case kLetExprNode:
+      if (!Pop(kExprClass, &expr) || !Pop(kStmtsClass, &stmts)) return false;
+      Push(arena_->New<LetExpr>(stmts, expr), kExprClass);
+      return true;
+
+    case kBinOpExprNode:
+      if (!ReadSpelling(&text) || !Pop(kExprClass, &expr2) ||
+          !Pop(kExprClass, &expr)) {
+        return false;
+      }
+      Push(arena_->New<BinOpExpr>(expr, text, expr2), kExprClass);
+      return true;
+
+    case kFunctionExprNode:
+      if (!Pop(kExprClass, &expr) || !Pop(kVarNameClass, &var)) return false;
+      Push(arena_->New<FunctionExpr>(var, expr), kExprClass);
+      return true;
+
+    case kMatrixExprNode:
+      if (!Pop(kExprClass, &expr2) || !Pop(kExprClass, &expr) ||
+          !Pop(kVarNameClass, &var)) {
+        return false;
+      }
+      Push(arena_->New<MatrixExpr>(var, expr, expr2), kExprClass);
+      return true;
+
+    case kIfExprNode:
+      if (!Pop(kExprClass, &expr3) || !Pop(kExprClass, &expr2) ||
+          !Pop(kExprClass, &expr)) {
+        return false;
+      }
+      Push(arena_->New<IfExpr>(expr, expr2, expr3), kExprClass);
+      return true;
+
+    case kParenExprNode:
+      if (!Pop(kExprClass, &expr)) return false;
+      Push(arena_->New<ParenExpr>(expr), kExprClass);
+      return true;
+
+    case kVarNameNode: {
+      int symbol;
+      if (!ReadInt(&symbol) || symbol < 0 || symbol >= symbols_->size()) {
+        return false;
+      }
+      Push(arena_->New<VarName>(symbol, symbols_), kVarNameClass);
+      return true;
+    }
+
+    case kAnyConstNode:
+      if (!ReadString(&text)) return false;
+      Push(arena_->New<AnyConst>(text), kExprClass);
+      return true;
+
+    case kNotExprNode:
+      if (!Pop(kExprClass, &expr)) return false;
+      Push(arena_->New<NotExpr>(expr), kExprClass);
+      return true;
+
+    case kTrueKwdExprNode:
+      Push(arena_->New<TrueKwdExpr>(), kExprClass);
+      return true;
+
+    case kFalseKwdExprNode:
+      Push(arena_->New<FalseKwdExpr>(), kExprClass);
+      return true;
+
+    default:
+      return false;
+  } /* switch() */
+} /* Build() */
+
+/*******************************************************************************
+ * Functions
+ ******************************************************************************/
+Root *LoadTree(const char *data, size_t size, parser::Arena *arena,
+               const scanner::SymbolTable *symbols) {
+  TreeLoader loader(data, size, arena, symbols);
+  return loader.Load();
+} /* LoadTree() */
+
+} /* namespace ast */
+} /* namespace fcal */
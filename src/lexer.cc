@@ -0,0 +1,199 @@
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <string.h>
+#include "include/lexer.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+namespace fcal {
+namespace scanner {
+
+/*******************************************************************************
+ * Helper Functions
+ ******************************************************************************/
+static constexpr bool IsDigit(char c) { return c >= '0' && c <= '9'; }
+
+static constexpr bool IsIdentStart(char c) {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+}
+
+static constexpr bool IsIdentChar(char c) {
+  return IsIdentStart(c) || IsDigit(c);
+}
+
+/*******************************************************************************
+ * Keyword Hash
+ *
+ * Keywords are found with a perfect hash of an identifier's first and
+ * last characters and its length, built at compile time from the
+ * spellings in kTokenSpecs. The static_assert below fails to compile if
+ * a new keyword collides with another, in which case the multipliers in
+ * KeywordHash need changing.
+ ******************************************************************************/
+/// Slots in the keyword table, a power of two.
+static const int kKeywordSlots = 32;
+
+static constexpr int KeywordHash(char first, char last, int length) {
+  return (first + 11 * last + 22 * length) & (kKeywordSlots - 1);
+}
+
+static constexpr int Length(const char *text) {
+  return *text == '\0' ? 0 : 1 + Length(text + 1);
+}
+
+/// Whether terminal t is spelt like an identifier.
+static constexpr bool IsKeyword(int t) {
+  return kTokenSpecs[t].spelling != nullptr &&
+         IsIdentStart(kTokenSpecs[t].spelling[0]);
+}
+
+static constexpr int SpellingHash(const char *spelling) {
+  return KeywordHash(spelling[0], spelling[Length(spelling) - 1],
+                     Length(spelling));
+}
+
+/// The first keyword from terminal t on that hashes to slot, or
+/// kVariableName if there is none.
+static constexpr int KeywordInSlot(int slot, int t) {
+  return t == kNumTerminals ? kVariableName :
+         IsKeyword(t) && SpellingHash(kTokenSpecs[t].spelling) == slot ? t :
+         KeywordInSlot(slot, t + 1);
+}
+
+/// Whether a keyword from terminal t on shares its slot with an earlier
+/// keyword.
+static constexpr bool HasCollision(int t) {
+  return t < kNumTerminals &&
+         ((IsKeyword(t) &&
+           KeywordInSlot(SpellingHash(kTokenSpecs[t].spelling), 0) != t) ||
+          HasCollision(t + 1));
+}
+
+static_assert(!HasCollision(0), "two keywords share a slot of the hash");
+
+#define FCAL_SLOT(i) static_cast<TokenType>(KeywordInSlot(i, 0))
+#define FCAL_SLOTS(i) FCAL_SLOT(i), FCAL_SLOT(i + 1), FCAL_SLOT(i + 2), \
+    FCAL_SLOT(i + 3)
+/// The keyword in each slot, or kVariableName for an empty slot.
+static constexpr TokenType kKeywordTable[kKeywordSlots] = {
+  FCAL_SLOTS(0), FCAL_SLOTS(4), FCAL_SLOTS(8), FCAL_SLOTS(12),
+  FCAL_SLOTS(16), FCAL_SLOTS(20), FCAL_SLOTS(24), FCAL_SLOTS(28)
+};
+#undef FCAL_SLOTS
+#undef FCAL_SLOT
+
+/*******************************************************************************
+ * Functions
+ ******************************************************************************/
+TokenType KeywordType(const char *text, int length) {
+  // An identifier can only be the keyword in its slot. strncmp stops at
+  // the end of a shorter spelling, and the null check rejects a longer
+  // one.
+  TokenType kwd = kKeywordTable[KeywordHash(text[0], text[length - 1],
+                                            length)];
+  if (kwd == kVariableName) return kVariableName;
+  const char *spelling = kTokenSpecs[kwd].spelling;
+  if (strncmp(text, spelling, length) == 0 && spelling[length] == '\0') {
+    return kwd;
+  }
+  return kVariableName;
+} /* KeywordType() */
+
+int MatchToken(const char *text, TokenType *terminal) {
+  const char *p = text;
+  char c = *p;
+
+  // Names and keywords
+  // ------------------
+  // A keyword pattern can never match more characters than the variable
+  // name pattern, and keywords come first in the terminal order, so the
+  // identifier is lexed once and then classified.
+  if (IsIdentStart(c)) {
+    do {
+      ++p;
+    } while (IsIdentChar(*p));
+    *terminal = KeywordType(text, static_cast<int>(p - text));
+    return static_cast<int>(p - text);
+  }
+
+  // Numeric constants
+  // -----------------
+  // intConst is [0-9]+ and floatConst is [0-9]*\.?[0-9]*; an int wins
+  // only when no '.' follows the digits.
+  if (IsDigit(c) || c == '.') {
+    while (IsDigit(*p)) ++p;
+    if (*p != '.') {
+      *terminal = kIntConst;
+      return static_cast<int>(p - text);
+    }
+    ++p;
+    while (IsDigit(*p)) ++p;
+    *terminal = kFloatConst;
+    return static_cast<int>(p - text);
+  }
+
+  switch (c) {
+    // String constants run to the next '"', which may be on a later
+    // line. Without one the quote is a lexical error on its own.
+    case '"': {
+      const char *close = strchr(text + 1, '"');
+      if (close == nullptr) break;
+      *terminal = kStringConst;
+      return static_cast<int>(close - text) + 1;
+    }
+
+    // Punctuation
+    case '(': *terminal = kLeftParen; return 1;
+    case ')': *terminal = kRightParen; return 1;
+    case '{': *terminal = kLeftCurly; return 1;
+    case '}': *terminal = kRightCurly; return 1;
+    case '[': *terminal = kLeftSquare; return 1;
+    case ']': *terminal = kRightSquare; return 1;
+    case ';': *terminal = kSemiColon; return 1;
+    case ':': *terminal = kColon; return 1;
+
+    // Operators
+    case '+': *terminal = kPlusSign; return 1;
+    case '*': *terminal = kStar; return 1;
+    case '-': *terminal = kDash; return 1;
+    case '/': *terminal = kForwardSlash; return 1;
+    case '=':
+      if (text[1] == '=') { *terminal = kEqualsEquals; return 2; }
+      *terminal = kAssign;
+      return 1;
+    case '<':
+      if (text[1] == '=') { *terminal = kLessThanEqual; return 2; }
+      *terminal = kLessThan;
+      return 1;
+    case '>':
+      if (text[1] == '=') { *terminal = kGreaterThanEqual; return 2; }
+      *terminal = kGreaterThan;
+      return 1;
+    case '!':
+      if (text[1] == '=') { *terminal = kNotEquals; return 2; }
+      *terminal = kNotOp;
+      return 1;
+    case '&':
+      if (text[1] == '&') { *terminal = kAndOp; return 2; }
+      break;
+    case '|':
+      if (text[1] == '|') { *terminal = kOrOp; return 2; }
+      break;
+
+    case '\0':
+      *terminal = kEndOfFile;
+      return 0;
+
+    default:
+      break;
+  } /* switch() */
+
+  // Anything else is a single character lexical error.
+  *terminal = kLexicalError;
+  return 1;
+} /* MatchToken() */
+
+} /* namespace scanner */
+} /* namespace fcal */
@@ -0,0 +1,49 @@
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "include/lexer_tables.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+namespace fcal {
+namespace scanner {
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+const LexerTables &LexerTables::Get(void) {
+  static const LexerTables tables;
+  return tables;
+} /* Get() */
+
+/*!
+ * The regular expressions for the FCAL dsl, one per terminal from its
+ * TokenSpec, followed by the white space and comment patterns skipped
+ * between tokens.
+ */
+LexerTables::LexerTables(void) {
+  for (int i = 0; i < kNumTerminals; i++) {
+    token_regex_[i] = make_regex(kTokenSpecs[i].pattern);
+  } /* for() */
+
+  white_space_ = make_regex("^[\n\t\r ]+");
+  block_comment_ = make_regex("^/\\*([^\\*]|\\*+[^\\*/])*\\*+/");
+  line_comment_ = make_regex("^//[^\n]*\n");
+} /* LexerTables() */
+
+LexerTables::~LexerTables(void) {
+  for (int i = 0; i < kNumTerminals; i++) {
+    regfree(token_regex_[i]);
+    delete token_regex_[i];
+  } /* for() */
+  regfree(white_space_);
+  delete white_space_;
+  regfree(block_comment_);
+  delete block_comment_;
+  regfree(line_comment_);
+  delete line_comment_;
+} /* ~LexerTables() */
+
+} /* namespace scanner */
+} /* namespace fcal */
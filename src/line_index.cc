@@ -0,0 +1,50 @@
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <string.h>
+#include <algorithm>
+#include "include/line_index.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+namespace fcal {
+namespace scanner {
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+void LineIndex::Reset(const char *text) {
+  text_ = text;
+  line_starts_.clear();
+  built_ = false;
+} /* Reset() */
+
+void LineIndex::Locate(int offset, int *line, int *column) {
+  if (!built_) Build();
+  // The line holding offset is the last one starting at or before it.
+  std::vector<int>::const_iterator next =
+      std::upper_bound(line_starts_.begin(), line_starts_.end(), offset);
+  int index = static_cast<int>(next - line_starts_.begin()) - 1;
+  *line = index + 1;
+  *column = offset - line_starts_[index] + 1;
+} /* Locate() */
+
+/*!
+ * Build() - Record where every line starts. memchr finds each newline
+ * far faster than testing the characters one by one.
+ */
+void LineIndex::Build(void) {
+  size_t length = strlen(text_);
+  const char *end = text_ + length;
+  line_starts_.push_back(0);
+  for (const char *p = text_;; ++p) {
+    p = static_cast<const char *>(memchr(p, '\n', end - p));
+    if (p == nullptr) break;
+    line_starts_.push_back(static_cast<int>(p + 1 - text_));
+  } /* for() */
+  built_ = true;
+} /* Build() */
+
+} /* namespace scanner */
+} /* namespace fcal */
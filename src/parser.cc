@@ -4,7 +4,6 @@
 #include "include/parser.h"
 #include <assert.h>
 #include <stdio.h>
-#include "include/ext_token.h"
 #include "include/scanner.h"
 #include "include/ast.h"
 
@@ -14,28 +13,111 @@
 namespace fcal {
 namespace parser {
 
+/*******************************************************************************
+ * Constant Definitions
+ ******************************************************************************/
+/// Tokens scanned each time the streaming window runs out.
+static const int kStreamBatch = 64;
+
+/// The nud and led of each terminal, indexed by TokenType. Binding
+/// powers are in kTokenSpecs.
+#define FCAL_NUD(name, spelling, pattern, nud, led, lbp, desc) \
+  &Parser::nud,
+const Parser::NudHandler Parser::kNud[] = {
+  FCAL_TOKENS(FCAL_NUD)
+};
+#undef FCAL_NUD
+
+#define FCAL_LED(name, spelling, pattern, nud, led, lbp, desc) \
+  &Parser::led,
+const Parser::LedHandler Parser::kLed[] = {
+  FCAL_TOKENS(FCAL_LED)
+};
+#undef FCAL_LED
+
 /*******************************************************************************
  * Constructors/Destructor
  ******************************************************************************/
 Parser::~Parser() {
   if (scanner_) delete scanner_;
+  // The token stream frees its single block in its own destructor.
+} /* Parser::~Parser() */
 
-  scanner::ExtToken *to_delete1;
-  curr_token_ = tokens_;
-  while (curr_token_) {
-    to_delete1 = curr_token_;
-    curr_token_ = curr_token_->next();
-    delete to_delete1;
-  } /* while() */
+/*!
+ * Parser::refill_tokens() - Slide the streaming window along the program.
+ * Only the previous and current tokens are ever looked at again, so the
+ * ones before prev_ are dropped before the next batch is scanned onto
+ * the end of the window.
+ */
+void Parser::refill_tokens() {
+  tokens_.Discard(prev_);
+  curr_ -= prev_;
+  prev_ = 0;
 
-  scanner::Token *curr_scanner_token = stokens_;
-  scanner::Token *to_delete2;
-  while (curr_scanner_token) {
-    to_delete2 = curr_scanner_token;
-    curr_scanner_token = curr_scanner_token->next();
-    delete to_delete2;
-  } /* while() */
-} /* Parser::~Parser() */
+  scan_offset_ = scanner_->ScanNext(tokens_.source(), scan_offset_,
+                                    kStreamBatch, &tokens_);
+} /* Parser::refill_tokens() */
+
+/*!
+ * Parser::prev_var_name() - Make a VarName for the token just matched.
+ * Variable names were interned as they were scanned; any other token
+ * is interned by its text here.
+ */
+ast::VarName *Parser::prev_var_name() {
+  int symbol = tokens_.symbol(prev_);
+  if (symbol < 0) {
+    symbol = symbols_->Intern(tokens_.text(prev_), tokens_.length(prev_));
+  }
+  return arena_->New<ast::VarName>(symbol, symbols_.get());
+} /* Parser::prev_var_name() */
+
+/// The spelling of the keyword or operator just matched, which is
+/// static and needs no copy.
+const char *Parser::prev_spelling() {
+  return scanner::kTokenSpecs[tokens_.terminal(prev_)].spelling;
+} /* Parser::prev_spelling() */
+
+/// The binding power of the operator just matched. Its right operand
+/// is parsed at this power, so that the operators after it that bind
+/// no tighter are left for the loop in parse_expr, which makes chains
+/// of them left associative without recursing once per operator.
+int Parser::prev_lbp() {
+  return scanner::kTokenSpecs[tokens_.terminal(prev_)].lbp;
+} /* Parser::prev_lbp() */
+
+/// A copy in the arena of the text of the token just matched.
+const char *Parser::prev_lexeme() {
+  return arena_->CopyString(tokens_.text(prev_), tokens_.length(prev_));
+} /* Parser::prev_lexeme() */
+
+/*!
+ * Parser::Reset() - Get ready for another parse. The arena and symbol
+ * table of the last parse are reused when the parser holds the only
+ * reference to them; a ParseResult still in use keeps its own and the
+ * parser starts new ones.
+ */
+void Parser::Reset() {
+  if (arena_ && arena_.use_count() == 1) {
+    arena_->Reset();
+  } else {
+    arena_ = std::make_shared<Arena>();
+  }
+  if (symbols_ && symbols_.use_count() == 1) {
+    symbols_->Clear();
+  } else {
+    symbols_ = std::make_shared<scanner::SymbolTable>();
+  }
+  tokens_.Reset(nullptr);
+  tokens_.symbol_table(symbols_.get());
+  lines_.Reset(nullptr);
+  stmt_stack_.clear();
+  start_stack_.clear();
+  failed_ = false;
+  error_.clear();
+  prev_ = 0;
+  curr_ = 0;
+  scan_offset_ = 0;
+} /* Parser::Reset() */
 
 /*!
  * Parser::Parse(const char *text) - 
@@ -46,23 +128,178 @@ ParseResult Parser::Parse(const char *text) {
   assert(text != nullptr);
 
   ParseResult pr;
-  try {
-  scanner_ = new scanner::Scanner();
-  stokens_ = scanner_->Scan(text);
-  tokens_ = tokens_->ExtendTokenList(this, stokens_);
-
-  assert(tokens_ != nullptr);
-  curr_token_ = tokens_;
-  pr = ParseProgram();
+  // Scanners hold no state, so one is kept for every parse.
+  if (scanner_ == nullptr) scanner_ = new scanner::Scanner();
+  Reset();
+  lines_.Reset(text);
+  if (streaming_) {
+    tokens_.Reset(text);
+    refill_tokens();
+  } else {
+    scanner_->Scan(text, &tokens_);
   }
-  catch (std::string errMsg) {
-  pr.ok(false);
-  pr.errors(errMsg);
-  pr.ast(nullptr);
+
+  assert(tokens_.size() > 0);
+  ast::Root *root = ParseProgram();
+  if (failed_) {
+    pr.ok(false);
+    pr.errors(error_);
+  } else {
+    pr.ast(root);
   }
+  pr.symbols(symbols_);
+  pr.arena(arena_);
+  pr.tree_bytes(arena_->used());
   return pr;
 } /* Parser::parse() */
 
+/*!
+ * Parser::Reparse() - Parse text, the program of previous after an edit
+ * replaced the old_length characters at offset begin with new_length
+ * others. Only the statements whose text touches the edit, in the
+ * innermost block holding it, are scanned and parsed again; every other
+ * statement of previous is reused as it is. If the edit is not inside
+ * a block of statements, or the statements it touches do not parse to
+ * statements ending where they did, the whole text is parsed, so the
+ * result is always the one Parse would give.
+ *
+ * The new tree shares the symbol table and arena of previous, into
+ * which any new names and nodes go, unless the arena has grown past
+ * kMaxReparseGrowth times the tree, in which case the whole text is
+ * parsed into a new one.
+ */
+ParseResult Parser::Reparse(const ParseResult &previous, const char *text,
+                            int begin, int old_length, int new_length) {
+  assert(text != nullptr);
+  ast::Root *root = static_cast<ast::Root *>(previous.ast());
+  if (!previous.ok() || root == nullptr) return Parse(text);
+  if (previous.arena()->used() > kMaxReparseGrowth * previous.tree_bytes()) {
+    return Parse(text);
+  }
+
+  if (scanner_ == nullptr) scanner_ = new scanner::Scanner();
+  Reset();
+  symbols_ = previous.symbols();
+  arena_ = previous.arena();
+  tokens_.symbol_table(symbols_.get());
+  tokens_.Reset(text);
+  lines_.Reset(text);
+
+  // Tokens are scanned a batch at a time from the first statement that
+  // is parsed again, so only as much of the text as is parsed is scanned.
+  bool streaming = streaming_;
+  streaming_ = true;
+  // StmtsBlock is the only kind of Stmts.
+  ast::StmtsBlock *block = reparse_block(
+      static_cast<ast::StmtsBlock *>(root->stmts()), root->body(), begin,
+      begin + old_length, new_length - old_length);
+  streaming_ = streaming;
+  if (block == nullptr) return Parse(text);
+
+  ParseResult pr;
+  pr.ast(arena_->New<ast::Root>(root->varName(), block, root->body()));
+  pr.symbols(symbols_);
+  pr.arena(arena_);
+  pr.tree_bytes(previous.tree_bytes());
+  return pr;
+} /* Parser::Reparse() */
+
+/*!
+ * Parser::reparse_block() - The block block of the old tree, whose
+ * offsets are kept from base, after an edit replaced the old text from
+ * begin to end and moved what followed it by shift. Returns nullptr if
+ * the edit is not within the statements of the block, leaving it to
+ * the enclosing block to parse again, or if the statements failed to
+ * parse, which also sets failed_.
+ */
+ast::StmtsBlock *Parser::reparse_block(ast::StmtsBlock *block, int base,
+                                       int begin, int end, int shift) {
+  int count = block->count();
+  if (count == 0 || begin < base || end > base + block->start(count)) {
+    return nullptr;
+  }
+
+  // Statements first to last are the ones whose text, with the space
+  // after it, touches the edit. The space before the first statement
+  // of the block goes with it.
+  int lo = 0;
+  int hi = count - 1;
+  while (lo < hi) {
+    int mid = lo + (hi - lo) / 2;
+    if (base + block->start(mid + 1) < begin) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  } /* while() */
+  int first = lo;
+  hi = count - 1;
+  while (lo < hi) {
+    int mid = hi - (hi - lo) / 2;
+    if (base + block->start(mid) > end) {
+      hi = mid - 1;
+    } else {
+      lo = mid;
+    }
+  } /* while() */
+  int last = lo;
+
+  size_t first_stmt = stmt_stack_.size();
+  size_t first_start = start_stack_.size();
+
+  // An edit inside the braces of a nested block is handled within it.
+  ast::StmtsStmt *nested =
+      first == last && block->stmt(first) ? block->stmt(first)->AsStmtsStmt()
+                                          : nullptr;
+  if (nested != nullptr) {
+    ast::StmtsBlock *inner = reparse_block(
+        static_cast<ast::StmtsBlock *>(nested->stmts()),
+        base + block->start(first) + 1, begin, end, shift);
+    if (failed_) return nullptr;
+    if (inner != nullptr) {
+      push_stmts(block, 0, first, 0);
+      stmt_stack_.push_back(arena_->New<ast::StmtsStmt>(inner));
+      start_stack_.push_back(block->start(first));
+      push_stmts(block, first + 1, count, shift);
+      start_stack_.push_back(block->start(count) + shift);
+      return make_block(first_stmt, first_start);
+    }
+  }
+
+  // Parse the statements from where the first of them began to where
+  // the statement after the last of them now begins.
+  int from = first == 0 ? base : base + block->start(first);
+  int to = base + block->start(last + 1) + shift;
+  scan_offset_ = from;
+  refill_tokens();
+
+  push_stmts(block, 0, first, 0);
+  while (tokens_.offset(curr_) < to) {
+    start_stack_.push_back(tokens_.offset(curr_) - base);
+    ast::Stmt *stmt = parse_stmt();
+    if (failed_) return nullptr;
+    stmt_stack_.push_back(stmt);
+  } /* while() */
+  if (tokens_.offset(curr_) != to) {
+    // The statements run on past where the next one began, so the
+    // edit changed more than these statements. Parse starts over.
+    failed_ = true;
+    return nullptr;
+  }
+  push_stmts(block, last + 1, count, shift);
+  start_stack_.push_back(block->start(count) + shift);
+  return make_block(first_stmt, first_start);
+} /* Parser::reparse_block() */
+
+/// Push statements from to to of block, moving their starts by shift.
+void Parser::push_stmts(ast::StmtsBlock *block, int from, int to,
+                        int shift) {
+  for (int i = from; i < to; i++) {
+    stmt_stack_.push_back(block->stmt(i));
+    start_stack_.push_back(block->start(i) + shift);
+  } /* for() */
+} /* Parser::push_stmts() */
+
 /*!
  * parse method for program.
  * The parser works by instantiating instances
@@ -72,538 +309,440 @@ ParseResult Parser::Parse(const char *text) {
  */
 
 // Program
-ParseResult Parser::ParseProgram() {
-  ParseResult pr;
+ast::Root *Parser::ParseProgram() {
   // root
   // Program ::= varName '(' ')' '{' Stmts '}'
-  match(scanner::kVariableName);
-  std::string name(prev_token_->lexeme());
-  ast::VarName *v = new ast::VarName(name);
+  if (!match(scanner::kVariableName)) return nullptr;
+  ast::VarName *v = prev_var_name();
 
-  match(scanner::kLeftParen);
-  match(scanner::kRightParen);
-  match(scanner::kLeftCurly);
+  if (!match(scanner::kLeftParen) || !match(scanner::kRightParen) ||
+      !match(scanner::kLeftCurly)) {
+    return nullptr;
+  }
+  int body = tokens_.offset(prev_) + tokens_.length(prev_);
 
-  ParseResult pr_stmts = parse_stmts();
-  ast::Stmts * stmts = nullptr;
-  stmts = ast::CastCheck<>(stmts, pr_stmts.ast(), "ParseProgram");
+  ast::Stmts *stmts = parse_stmts();
+  if (failed_) return nullptr;
 
-  match(scanner::kRightCurly);
-  match(scanner::kEndOfFile);
+  if (!match(scanner::kRightCurly) || !match(scanner::kEndOfFile)) {
+    return nullptr;
+  }
 
-  pr.ast(new ast::Root(v, stmts));
-  return pr;
+  return arena_->New<ast::Root>(v, stmts, body);
 } /* Parser::ParseProgram() */
 
 // MatrixDecl
 // identical purpose of parse_decl, handles special matrix syntax.
-ParseResult Parser::parse_matrix_decl() {
-  ParseResult pr;
-  ParseResult pr_expr;
-  ast::Expr *expr = nullptr;
-  match(scanner::kMatrixKwd);
-  match(scanner::kVariableName);
-  std::string name(prev_token_->lexeme());
-  ast::VarName *var = new ast::VarName(name);
+ast::Decl *Parser::parse_matrix_decl() {
+  ast::Decl *decl = nullptr;
+  if (!match(scanner::kMatrixKwd) || !match(scanner::kVariableName)) {
+    return nullptr;
+  }
+  ast::VarName *var = prev_var_name();
 
   // Decl ::= 'matrix' varName '[' Expr ':' Expr ']' varName ':' varName  '='
   // Expr ';'
   if (attempt_match(scanner::kLeftSquare)) {
-    ast::Expr * expr2 = nullptr;
-    ast::Expr * expr3 = nullptr;
-    ParseResult pr_expr2;
-    ParseResult pr_expr3;
-    ParseResult pr_var2;
-    ParseResult pr_var3;
+    ast::Expr *expr = parse_expr(0);
+    if (failed_ || !match(scanner::kColon)) return nullptr;
 
-    pr_expr = parse_expr(0);
-    expr = ast::CastCheck<> (expr, pr_expr.ast(), "parse_matrix_decl Expr1");
-      match(scanner::kColon);
+    ast::Expr *expr2 = parse_expr(0);
+    if (failed_ || !match(scanner::kRightSquare)) return nullptr;
 
-    pr_expr2 = parse_expr(0);
-    expr2 = ast::CastCheck<> (expr2, pr_expr2.ast(), "parse_matrix_decl Expr2");
-      match(scanner::kRightSquare);
+    parse_variable_name();
+    if (failed_) return nullptr;
+    ast::VarName *var2 = prev_var_name();
+    if (!match(scanner::kColon)) return nullptr;
 
-    pr_var2 = parse_variable_name();
-    ast::VarName * var2 = new ast::VarName(prev_token_->lexeme());
-      match(scanner::kColon);
+    parse_variable_name();
+    if (failed_) return nullptr;
+    ast::VarName *var3 = prev_var_name();
+    if (!match(scanner::kAssign)) return nullptr;
 
-    pr_var3 = parse_variable_name();
-    ast::VarName * var3 = new ast::VarName(prev_token_->lexeme());
-      match(scanner::kAssign);
-
-    pr_expr3 = parse_expr(0);
-    expr3 = ast::CastCheck<> (expr3, pr_expr3.ast(), "parse_matrix_decl Expr3");
-    pr.ast(new ast::LongMatrixDecl(var, expr, expr2, var2, var3, expr3));
+    ast::Expr *expr3 = parse_expr(0);
+    if (failed_) return nullptr;
+    decl = arena_->New<ast::LongMatrixDecl>(var, expr, expr2, var2, var3,
+                                            expr3);
 
   } else if (attempt_match(scanner::kAssign)) {
     // Decl ::= 'matrix' varName '=' Expr ';'
-    pr_expr = parse_expr(0);
-    expr = ast::CastCheck<>(expr, pr_expr.ast(), "parse_matrix_decl Expr");
-    pr.ast(new ast::ShortMatrixDecl(var, expr));
+    ast::Expr *expr = parse_expr(0);
+    if (failed_) return nullptr;
+    decl = arena_->New<ast::ShortMatrixDecl>(var, expr);
   } else {
-    throw((std::string) "Bad Syntax Matrix Decl in in parse_matrix_decl");
+    fail(error_location() + "Bad Syntax Matrix Decl in in parse_matrix_decl");
+    return nullptr;
   }
 
   match(scanner::kSemiColon);
 
-  return pr;
+  return decl;
 }
 // standardDecl
 // Decl ::= integerKwd varName | floatKwd varName | stringKwd varName
-ParseResult Parser::parse_standard_decl() {
-  ParseResult pr;
-  std::string * kwdType = nullptr;
+ast::Decl *Parser::parse_standard_decl() {
+  const char *kwdType = nullptr;
 
   if (attempt_match(scanner::kIntKwd)) {  // Type ::= intKwd
-    kwdType = new std::string (prev_token_->lexeme());
+    kwdType = prev_spelling();
   } else if (attempt_match(scanner::kFloatKwd)) {  // Type ::= floatKwd
-    kwdType = new std::string (prev_token_->lexeme());
+    kwdType = prev_spelling();
   } else if (attempt_match(scanner::kStringKwd)) {  // Type ::= stringKwd
-    kwdType = new std::string (prev_token_->lexeme());
+    kwdType = prev_spelling();
   } else if (attempt_match(scanner::kBoolKwd)) {  // Type ::= boolKwd
-    kwdType = new std::string (prev_token_->lexeme());
+    kwdType = prev_spelling();
   }
 
-  match(scanner::kVariableName);
-  ast::VarName *v = new ast::VarName(prev_token_->lexeme());
-  match(scanner::kSemiColon);
+  if (!match(scanner::kVariableName)) return nullptr;
+  ast::VarName *v = prev_var_name();
+  if (!match(scanner::kSemiColon)) return nullptr;
 
-  pr.ast(new ast::SimpleDecl(kwdType, v));
-  return pr;
+  return arena_->New<ast::SimpleDecl>(kwdType, v);
 }
 
 // Decl
-ParseResult Parser::parse_decl() {
-  ParseResult pr;
-  ParseResult pr_simple;
-  ast::Decl * d = nullptr;
+ast::Decl *Parser::parse_decl() {
   // Decl :: matrix variableName ....
   if (next_is(scanner::kMatrixKwd)) {
-    pr = parse_matrix_decl();
+    return parse_matrix_decl();
   } else {  // Decl ::= Type variableName semiColon
-    pr_simple = parse_standard_decl();
-    d = ast::CastCheck<> (d, pr_simple.ast(), "parse_decl");
-    pr.ast(d);
+    return parse_standard_decl();
   }
-  return pr;
 }
 
 // Stmts
-ParseResult Parser::parse_stmts() {
-  ParseResult pr;
-  if (!next_is(scanner::kRightCurly) && !next_is(scanner::kInKwd)) {
-    // Stmts ::= Stmt Stmts
-    ParseResult pr_stmt = parse_stmt();
-    ast::Stmt *stmt = nullptr;
-    stmt = ast::CastCheck<>(stmt, pr_stmt.ast(), "parse_stmts ; 'stmt'");
-
-    ParseResult pr_stmts = parse_stmts();
-    ast::Stmts *stmts = nullptr;
-    stmts = ast::CastCheck<>(stmts, pr_stmts.ast(), "parse_stmts ; 'stmts'");
-    // ast::StmtsSeq *seq = new ast::StmtsSeq(dynamic_cast<ast::Stmt*>
-    // (pr_stmt.ast()), dynamic_cast<ast::Stmts*>(pr_stmts.ast()));
-
-    pr.ast(new ast::StmtsSeq(stmt, stmts));
-  } else {
-    // Stmts ::=
-    // nothing to match.k
-    // ast::EmptyStmts *eseq = new ast::EmptyStmts();
-    pr.ast(new ast::EmptyStmts());
+// Stmts ::= Stmt Stmts | <<empty>>, parsed as a loop. The statements are
+// gathered on stmt_stack_, and where each starts on start_stack_, which
+// nested blocks share, and copied into arrays in the arena when the
+// block ends. It is called just after the token opening the block.
+ast::Stmts *Parser::parse_stmts() {
+  int base = tokens_.offset(prev_) + tokens_.length(prev_);
+  size_t first_stmt = stmt_stack_.size();
+  size_t first_start = start_stack_.size();
+  while (!next_is(scanner::kRightCurly) && !next_is(scanner::kInKwd)) {
+    start_stack_.push_back(tokens_.offset(curr_) - base);
+    ast::Stmt *stmt = parse_stmt();
+    if (failed_) return nullptr;
+    stmt_stack_.push_back(stmt);
   }
-  return pr;
+  start_stack_.push_back(tokens_.offset(curr_) - base);
+
+  return make_block(first_stmt, first_start);
+}
+
+/// A block of the statements on stmt_stack_ from first_stmt on, which
+/// start at the offsets on start_stack_ from first_start on. Both are
+/// popped.
+ast::StmtsBlock *Parser::make_block(size_t first_stmt, size_t first_start) {
+  int count = static_cast<int>(stmt_stack_.size() - first_stmt);
+  ast::Stmt **stmts =
+      arena_->CopyArray(stmt_stack_.data() + first_stmt, count);
+  const int *starts =
+      arena_->CopyArray(start_stack_.data() + first_start, count + 1);
+  stmt_stack_.resize(first_stmt);
+  start_stack_.resize(first_start);
+  return arena_->New<ast::StmtsBlock>(stmts, count, starts);
 }
 
 // Stmt
-ParseResult Parser::parse_stmt() {
-  ParseResult pr;
-  ParseResult pr_tmp1;
-  ParseResult pr_tmp2;
-  ParseResult pr_tmp3;
-  ast::VarName *var = nullptr;
-  ast::Expr * exp1 = nullptr;
-  ast::Expr * exp2 = nullptr;
-  ast::Expr * exp3 = nullptr;
+ast::Stmt *Parser::parse_stmt() {
+  ast::Stmt *result = nullptr;
 
   // Stmt ::= Decl
   if (next_is(scanner::kIntKwd) || next_is(scanner::kFloatKwd) ||
       next_is(scanner::kMatrixKwd) || next_is(scanner::kStringKwd) ||
       next_is(scanner::kBoolKwd)) {
-    ParseResult ds = parse_decl();
-    ast::Decl *decl = nullptr;
-    decl = ast::CastCheck<>(decl, ds.ast(), "parse_stmt ; 'decl'");
-
-    ast::Stmt * stmt = dynamic_cast<ast::Stmt*> (new ast::DeclStmt(decl));
-    if (!stmt) {std::cout << "ALERT\n";}
-    pr.ast(stmt);
-    // ast::DeclStmt *decls =
-    // new ast::DeclStmt(dynamic_cast<ast::Decl*>(ds.ast()));
-
+    ast::Decl *decl = parse_decl();
+    if (failed_) return nullptr;
+    result = arena_->New<ast::DeclStmt>(decl);
 
   } else if (attempt_match(scanner::kLeftCurly)) {
     // Stmt ::= '{' Stmts '}'
-    ast::Stmts * stmts = nullptr;
-    pr_tmp1 = parse_stmts();
-    stmts = ast::CastCheck<>(stmts, pr_tmp1.ast(), "parse_stmt ; 'StmtsStmt'");
-    match(scanner::kRightCurly);
-    pr.ast(new ast::StmtsStmt(stmts));
+    ast::Stmts *stmts = parse_stmts();
+    if (failed_ || !match(scanner::kRightCurly)) return nullptr;
+    result = arena_->New<ast::StmtsStmt>(stmts);
 
   } else if (attempt_match(scanner::kIfKwd)) {
     // Stmt ::= 'if' '(' Expr ')' Stmt
     // Stmt ::= 'if' '(' Expr ')' Stmt 'else' Stmt
-    ast::Stmt * stmt = nullptr;
-    match(scanner::kLeftParen);
+    if (!match(scanner::kLeftParen)) return nullptr;
 
-    pr_tmp1 = parse_expr(0);
-    exp1 = ast::CastCheck<>(exp1, pr_tmp1.ast(), "parse_stmt IfStmt Expr1");
-    match(scanner::kRightParen);
+    ast::Expr *expr = parse_expr(0);
+    if (failed_ || !match(scanner::kRightParen)) return nullptr;
 
-    pr_tmp2 = parse_stmt();
-    stmt = ast::CastCheck<>(stmt, pr_tmp2.ast(), "parse_stmt IfStmt stmt");
-    pr.ast(new ast::IfStmt(exp1, stmt));
+    ast::Stmt *stmt = parse_stmt();
+    if (failed_) return nullptr;
+    result = arena_->New<ast::IfStmt>(expr, stmt);
 
     if (attempt_match(scanner::kElseKwd)) {
-      ast::Stmt * stmt2 = nullptr;
-      pr_tmp3 = parse_stmt();
-      stmt2 = ast::CastCheck<>(stmt2, pr_tmp3.ast(), "parse_stmt IfStmt stmt2");
-      pr.ast(new ast::IfElseStmt(exp1, stmt, stmt2));
+      ast::Stmt *stmt2 = parse_stmt();
+      if (failed_) return nullptr;
+      result = arena_->New<ast::IfElseStmt>(expr, stmt, stmt2);
     }
   } else if (attempt_match(scanner::kVariableName)) {
-      var = new ast::VarName(prev_token_->lexeme());
+    ast::VarName *var = prev_var_name();
     /*
      * Stmt ::= varName '=' Expr ';'  | varName '[' Expr ':' Expr ']'
      * '=' Expr ';'
      */
     if (attempt_match(scanner::kLeftSquare)) {
-      pr_tmp1 = parse_expr(0);
-      exp1 = ast::CastCheck<>(exp1, pr_tmp1.ast(), "MatrixAssign expr1");
+      ast::Expr *expr1 = parse_expr(0);
+      if (failed_ || !match(scanner::kColon)) return nullptr;
 
-      match(scanner::kColon);
-
-      pr_tmp2 = parse_expr(0);
-      exp2 = ast::CastCheck<>(exp2, pr_tmp2.ast(), "MatrixAssign expr2");
-
-      match(scanner::kRightSquare);
-
-      match(scanner::kAssign);
+      ast::Expr *expr2 = parse_expr(0);
+      if (failed_ || !match(scanner::kRightSquare) ||
+          !match(scanner::kAssign)) {
+        return nullptr;
+      }
 
-      pr_tmp3 = parse_expr(0);
-      exp3 = ast::CastCheck<>(exp3, pr_tmp3.ast(), "MatrixAssign expr3");
-      match(scanner::kSemiColon);
-      pr.ast(new ast::AssignMatrixStmt(var, exp1, exp2, exp3));
+      ast::Expr *expr3 = parse_expr(0);
+      if (failed_ || !match(scanner::kSemiColon)) return nullptr;
+      result = arena_->New<ast::AssignMatrixStmt>(var, expr1, expr2, expr3);
 
     } else if (attempt_match(scanner::kAssign)) {
-        pr_tmp1 = parse_expr(0);
-        exp1 = ast::CastCheck(exp1, pr_tmp1.ast(), "Assign");
-        match(scanner::kSemiColon);
-        pr.ast(new ast::AssignStmt(var, exp1));
-      }
+      ast::Expr *expr = parse_expr(0);
+      if (failed_ || !match(scanner::kSemiColon)) return nullptr;
+      result = arena_->New<ast::AssignStmt>(var, expr);
+    }
 
   } else if (attempt_match(scanner::kPrintKwd)) {
     // Stmt ::= 'print' '(' Expr ')' ';'
-    match(scanner::kLeftParen);
-    ast::Expr * expr = nullptr;
-    pr_tmp1 = parse_expr(0);
-    expr = ast::CastCheck<>(expr, pr_tmp1.ast(), "Print");
-
-    match(scanner::kRightParen);
-    match(scanner::kSemiColon);
+    if (!match(scanner::kLeftParen)) return nullptr;
+    ast::Expr *expr = parse_expr(0);
+    if (failed_ || !match(scanner::kRightParen) ||
+        !match(scanner::kSemiColon)) {
+      return nullptr;
+    }
 
-    pr.ast(new ast::PrintStmt(expr));
+    result = arena_->New<ast::PrintStmt>(expr);
 
   } else if (attempt_match(scanner::kRepeatKwd)) {
     // Stmt ::= 'repeat' '(' varName '=' Expr 'to' Expr ')' Stmt
-    ast::Stmt * stmt = nullptr;
-    ast::Expr * expr1 = nullptr;
-    ast::Expr * expr2 = nullptr;
-
-    match(scanner::kLeftParen);
-    match(scanner::kVariableName);
-    var = new ast::VarName(prev_token_->lexeme());
-    match(scanner::kAssign);
+    if (!match(scanner::kLeftParen) || !match(scanner::kVariableName)) {
+      return nullptr;
+    }
+    ast::VarName *var = prev_var_name();
+    if (!match(scanner::kAssign)) return nullptr;
 
-    pr_tmp1 = parse_expr(0);
-    expr1 = ast::CastCheck<>(expr1, pr_tmp1.ast(), "parse RepeatStmt expr1");
-    match(scanner::kToKwd);
+    ast::Expr *expr1 = parse_expr(0);
+    if (failed_ || !match(scanner::kToKwd)) return nullptr;
 
-    pr_tmp2 = parse_expr(0);
-    expr2 = ast::CastCheck<>(expr2, pr_tmp2.ast(), "parse RepeatStmt expr2");
-    match(scanner::kRightParen);
+    ast::Expr *expr2 = parse_expr(0);
+    if (failed_ || !match(scanner::kRightParen)) return nullptr;
 
-    pr_tmp3 = parse_stmt();
-    stmt = ast::CastCheck<>(stmt, pr_tmp3.ast(), "parse Repeatstmt stmt");
-    pr.ast(new ast::RepeatStmt(var, expr1, expr2, stmt));
+    ast::Stmt *stmt = parse_stmt();
+    if (failed_) return nullptr;
+    result = arena_->New<ast::RepeatStmt>(var, expr1, expr2, stmt);
 
   } else if (attempt_match(scanner::kWhileKwd)) {
     // Stmt ::= 'while' '(' Expr ')' Stmt
-    ast::Stmt * stmt = nullptr;
-    ast::Expr * expr = nullptr;
-    match(scanner::kLeftParen);
+    if (!match(scanner::kLeftParen)) return nullptr;
 
-    pr_tmp1 = parse_expr(0);
-    expr = ast::CastCheck<>(expr, pr_tmp1.ast(), "parse WhileStmt expr");
-    match(scanner::kRightParen);
+    ast::Expr *expr = parse_expr(0);
+    if (failed_ || !match(scanner::kRightParen)) return nullptr;
 
-    pr_tmp2 = parse_stmt();
-    stmt = ast::CastCheck<>(stmt, pr_tmp2.ast(), "parse WhileStmt stmt");
+    ast::Stmt *stmt = parse_stmt();
+    if (failed_) return nullptr;
 
-    pr.ast(new ast::WhileStmt(expr, stmt));
+    result = arena_->New<ast::WhileStmt>(expr, stmt);
 
   } else if (attempt_match(scanner::kSemiColon)) {
     // Stmt ::= ';
-    pr.ast(new ast::SemiColonStmt());
+    result = arena_->New<ast::SemiColonStmt>();
     // parsed a skip
   } else {
-    throw(make_error_msg(curr_token_->terminal()) +
-          " while parsing a statement");
+    fail(make_error_msg(tokens_.terminal(curr_)) +
+         " while parsing a statement");
   }
   // Stmt ::= variableName assign Expr semiColon
-  return pr;
+  return result;
 }
 
 // Expr
 /*!
  Examine current token, without consuming it, to call its
- associated parse methods.  The ExtToken objects have 'nud' and
- 'led' methods that are dispatchers that call the appropriate
- parse methods.
+ associated parse methods.  The 'nud' and 'led' of its terminal are
+ looked up in kNud and kLed and its binding power in kTokenSpecs.
+ Each led parses its right operand at its own binding power and
+ returns, so a chain of operators grows the tree to the left in this
+ loop and the stack only deepens as the precedence rises.
 */
-ParseResult Parser::parse_expr(int rbp) {
-  ParseResult left = curr_token_->nud();
+ast::Expr *Parser::parse_expr(int rbp) {
+  ast::Expr *left = (this->*kNud[tokens_.terminal(curr_)])();
 
-  while (rbp < curr_token_->lbp()) {
-    left = curr_token_->led(left);
+  while (!failed_ && rbp < scanner::kTokenSpecs[tokens_.terminal(curr_)].lbp) {
+    left = (this->*kLed[tokens_.terminal(curr_)])(left);
   }
 
   return left;
 }
 
+/// The nud of a token that cannot start an expression.
+ast::Expr *Parser::no_nud() { return nullptr; }
+
+/// The led of a token that cannot follow an operand. Such tokens may
+/// still bind, as '(' does, so this must fail rather than return left,
+/// or parse_expr would never get past them.
+ast::Expr *Parser::no_led(ast::Expr *left) {
+  fail(make_error_msg(tokens_.terminal(curr_)) +
+       " while parsing an expression");
+  return left;
+}
+
 /*
  * parse methods for Expr productions
  * ----------------------------------
  */
 
 // Expr ::= trueKwd
-ParseResult Parser::parse_true_kwd() {
-  ParseResult pr;
-  match(scanner::kTrueKwd);
-  pr.ast(new ast::TrueKwdExpr());
-  return pr;
+ast::Expr *Parser::parse_true_kwd() {
+  if (!match(scanner::kTrueKwd)) return nullptr;
+  return arena_->New<ast::TrueKwdExpr>();
 }
 
 // Expr ::= trueKwd
-ParseResult Parser::parse_false_kwd() {
-  ParseResult pr;
-  match(scanner::kFalseKwd);
-  pr.ast(new ast::FalseKwdExpr());
-  return pr;
+ast::Expr *Parser::parse_false_kwd() {
+  if (!match(scanner::kFalseKwd)) return nullptr;
+  return arena_->New<ast::FalseKwdExpr>();
 }
 
 // Expr ::= intConst
-ParseResult Parser::parse_int_const() {
-  ParseResult pr;
-  match(scanner::kIntConst);
-  pr.ast(new ast::AnyConst(new std::string(prev_token_->lexeme())));
-  return pr;
+ast::Expr *Parser::parse_int_const() {
+  if (!match(scanner::kIntConst)) return nullptr;
+  return arena_->New<ast::AnyConst>(prev_lexeme());
 }
 
 // Expr ::= floatConst
-ParseResult Parser::parse_float_const() {
-  ParseResult pr;
-  match(scanner::kFloatConst);
-  pr.ast(new ast::AnyConst(new std::string(prev_token_->lexeme())));
-  return pr;
+ast::Expr *Parser::parse_float_const() {
+  if (!match(scanner::kFloatConst)) return nullptr;
+  return arena_->New<ast::AnyConst>(prev_lexeme());
 }
 
 // Expr ::= stringConst
-ParseResult Parser::parse_string_const() {
-  ParseResult pr;
-  match(scanner::kStringConst);
-  pr.ast(new ast::AnyConst(new std::string(prev_token_->lexeme())));
-  return pr;
+ast::Expr *Parser::parse_string_const() {
+  if (!match(scanner::kStringConst)) return nullptr;
+  return arena_->New<ast::AnyConst>(prev_lexeme());
 }
 
 // Expr ::= variableName .....
-ParseResult Parser::parse_variable_name() {
-  ParseResult pr;
-  match(scanner::kVariableName);
-  ast::VarName * var = new ast::VarName(prev_token_->lexeme());
+ast::Expr *Parser::parse_variable_name() {
+  if (!match(scanner::kVariableName)) return nullptr;
+  ast::VarName *var = prev_var_name();
   if (attempt_match(scanner::kLeftSquare)) {
-    ParseResult pr_expr1 = parse_expr(0);
-    ast::Expr *expr1 = nullptr;
-    expr1 = ast::CastCheck<>(expr1, pr_expr1.ast(),
-                             "parse_variable_name ; expr1");
-    match(scanner::kColon);
-
-    ParseResult pr_expr2 = parse_expr(0);
-    ast::Expr *expr2 = nullptr;
-    expr2 = ast::CastCheck<>(expr2, pr_expr2.ast(),
-                             "parse_variable_name ; epxr2");
-    match(scanner::kRightSquare);
-
-    pr.ast(new ast::MatrixExpr(var, expr1, expr2));
+    ast::Expr *expr1 = parse_expr(0);
+    if (failed_ || !match(scanner::kColon)) return nullptr;
+
+    ast::Expr *expr2 = parse_expr(0);
+    if (failed_ || !match(scanner::kRightSquare)) return nullptr;
+
+    return arena_->New<ast::MatrixExpr>(var, expr1, expr2);
   }  else if (attempt_match(scanner::kLeftParen)) {
     // Expr ::= varableName '(' Expr ')'
-    ParseResult pr_expr = parse_expr(0);
-    ast::Expr * expr = nullptr;
-    expr = ast::CastCheck<>(expr, pr_expr.ast(), "parse_variable_name ; expr");
-    match(scanner::kRightParen);
-    pr.ast(new ast::FunctionExpr(var, expr));
+    ast::Expr *expr = parse_expr(0);
+    if (failed_ || !match(scanner::kRightParen)) return nullptr;
+    return arena_->New<ast::FunctionExpr>(var, expr);
   } else {
     // variable
-    pr.ast(var);
+    return var;
   }
-  return pr;
 }
 
 // Expr ::= leftParen Expr rightParen
-ParseResult Parser::parse_nested_expr() {
-  ParseResult pr;
-  match(scanner::kLeftParen);
-  ast::Expr * expr = nullptr;
-  ParseResult pr_expr = parse_expr(0);
-  expr = ast::CastCheck<>(expr, pr_expr.ast(), "parse_nested_expr");
-  match(scanner::kRightParen);
-  pr.ast(new ast::ParenExpr(expr));
-  return pr;
+ast::Expr *Parser::parse_nested_expr() {
+  if (!match(scanner::kLeftParen)) return nullptr;
+  ast::Expr *expr = parse_expr(0);
+  if (failed_ || !match(scanner::kRightParen)) return nullptr;
+  return arena_->New<ast::ParenExpr>(expr);
 }
 
 // Expr ::= 'if' Expr 'then' Expr 'else' Expr
-ParseResult Parser::parse_if_expr() {
-  ParseResult pr;
+ast::Expr *Parser::parse_if_expr() {
+  if (!match(scanner::kIfKwd)) return nullptr;
 
-  match(scanner::kIfKwd);
+  ast::Expr *expr1 = parse_expr(0);
+  if (failed_ || !match(scanner::kThenKwd)) return nullptr;
 
-  ParseResult pr_expr1 = parse_expr(0);
-  ast::Expr * expr1 = nullptr;
-  expr1 = ast::CastCheck<>(expr1, pr_expr1.ast(), "parse_if_expr ; expr1");
-  match(scanner::kThenKwd);
+  ast::Expr *expr2 = parse_expr(0);
+  if (failed_ || !match(scanner::kElseKwd)) return nullptr;
 
-  ParseResult pr_expr2 = parse_expr(0);
-  ast::Expr * expr2 = nullptr;
-  expr2 = ast::CastCheck<>(expr2, pr_expr2.ast(), "parse_if_expr ; expr2");
-  match(scanner::kElseKwd);
+  ast::Expr *expr3 = parse_expr(0);
+  if (failed_) return nullptr;
 
-
-  ParseResult pr_expr3 = parse_expr(0);
-  ast::Expr * expr3 = nullptr;
-  expr3 = ast::CastCheck<>(expr3, pr_expr3.ast(), "parse_if_expr ; expr3");
-
-  pr.ast(new ast::IfExpr(expr1, expr2, expr3));
-
-  return pr;
+  return arena_->New<ast::IfExpr>(expr1, expr2, expr3);
 }
 
 // Expr ::= 'let' Stmts 'in' Expr 'end'
-ParseResult Parser::parse_let_expr() {
-  ParseResult pr;
-  match(scanner::kLetKwd);
-
-  ParseResult pr_stmts = parse_stmts();
-  ast::Stmts * stmts = nullptr;
-  stmts = ast::CastCheck<>(stmts, pr_stmts.ast(), "parse_let_expr ; stmts");
-  match(scanner::kInKwd);
+ast::Expr *Parser::parse_let_expr() {
+  if (!match(scanner::kLetKwd)) return nullptr;
 
-  ParseResult pr_expr = parse_expr(0);
-  ast::Expr * expr = nullptr;
-  expr = ast::CastCheck<>(expr, pr_expr.ast(), "parse_let_expr ; expr");
-  match(scanner::kEndKwd);
+  ast::Stmts *stmts = parse_stmts();
+  if (failed_ || !match(scanner::kInKwd)) return nullptr;
 
-  pr.ast(new ast::LetExpr(stmts, expr));
+  ast::Expr *expr = parse_expr(0);
+  if (failed_ || !match(scanner::kEndKwd)) return nullptr;
 
-  return pr;
+  return arena_->New<ast::LetExpr>(stmts, expr);
 }
 
 // Expr ::= '!' Expr
-ParseResult Parser::parse_not_expr() {
-  ParseResult pr;
-  match(scanner::kNotOp);
+ast::Expr *Parser::parse_not_expr() {
+  if (!match(scanner::kNotOp)) return nullptr;
 
-  ParseResult pr_expr = parse_expr(0);
-  ast::Expr * expr = nullptr;
-  expr = ast::CastCheck<>(expr, pr_expr.ast(), "parse_not_expr");
+  ast::Expr *expr = parse_expr(0);
+  if (failed_) return nullptr;
 
-  pr.ast(new ast::NotExpr(expr));
-
-  return pr;
+  return arena_->New<ast::NotExpr>(expr);
 }
 
 // Expr ::= Expr plusSign Expr
-ParseResult Parser::parse_addition(ParseResult prLeft) {
+ast::Expr *Parser::parse_addition(ast::Expr *left) {
   // parser has already matched left expression
-  ParseResult pr;
-  ast::Expr *left = nullptr;
-  left = ast::CastCheck<>(left, prLeft.ast(), "parse_addition ; left");
-  match(scanner::kPlusSign);
+  if (!match(scanner::kPlusSign)) return nullptr;
 
-  std::string * op = new std::string(prev_token_->lexeme());
+  const char *op = prev_spelling();
 
-  ParseResult prRight = parse_expr(0);
-  // parse_expr(prev_token_->lbp());
-  ast::Expr *right = nullptr;
-  right = ast::CastCheck<>(right, prRight.ast(), "parse_addition ; right");
+  ast::Expr *right = parse_expr(prev_lbp());
+  if (failed_) return nullptr;
 
-  pr.ast(new ast::BinOpExpr(left, op, right));
-  return pr;
+  return arena_->New<ast::BinOpExpr>(left, op, right);
 }
 
 // Expr ::= Expr star Expr
-ParseResult Parser::parse_multiplication(ParseResult prLeft) {
+ast::Expr *Parser::parse_multiplication(ast::Expr *left) {
   // parser has already matchekD left expression
-  ParseResult pr;
-
-  ast::Expr * left = nullptr;
-  left = ast::CastCheck<>(left, prLeft.ast(), "parse_multiplication ; left");
-  match(scanner::kStar);
+  if (!match(scanner::kStar)) return nullptr;
 
-  std::string * op = new std::string(prev_token_->lexeme());
+  const char *op = prev_spelling();
 
-  ParseResult prRight = parse_expr(0);
-  // parse_expr(prev_token_->lbp());
-  ast::Expr * right = nullptr;
-  right = ast::CastCheck<>(right, prRight.ast(),
-                           "parse_multiplication ; right");
-  pr.ast(new ast::BinOpExpr(left, op, right));
+  ast::Expr *right = parse_expr(prev_lbp());
+  if (failed_) return nullptr;
 
-  return pr;
+  return arena_->New<ast::BinOpExpr>(left, op, right);
 }
 
 // Expr ::= Expr dash Expr
-ParseResult Parser::parse_subtraction(ParseResult prLeft) {
+ast::Expr *Parser::parse_subtraction(ast::Expr *left) {
   // parser has already matchekD left expression
-  ParseResult pr;
+  if (!match(scanner::kDash)) return nullptr;
 
-  ast::Expr * left = nullptr;
-  left = ast::CastCheck<>(left, prLeft.ast(), "parse_subtraction ; left");
-  match(scanner::kDash);
+  const char *op = prev_spelling();
+  ast::Expr *right = parse_expr(prev_lbp());
+  if (failed_) return nullptr;
 
-  std::string * op = new std::string(prev_token_->lexeme());
-  ParseResult prRight = parse_expr(0);
-  // parse_expr(prev_token_->lbp());
-  ast::Expr * right = nullptr;
-  right = ast::CastCheck<>(right, prRight.ast(), "parse_subtraction ; right");
-  pr.ast(new ast::BinOpExpr(left, op, right));
-
-  return pr;
+  return arena_->New<ast::BinOpExpr>(left, op, right);
 }
 
 // Expr ::= Expr forwardSlash Expr
-ParseResult Parser::parse_division(ParseResult prLeft) {
+ast::Expr *Parser::parse_division(ast::Expr *left) {
   // parser has already matchekD left expression
-  ParseResult pr;
-  ast::Expr * left = nullptr;
-  left = ast::CastCheck<>(left, prLeft.ast(), "parse_division ; left");
-  match(scanner::kForwardSlash);
+  if (!match(scanner::kForwardSlash)) return nullptr;
 
-  std::string * op = new std::string(prev_token_->lexeme());
+  const char *op = prev_spelling();
 
-  ParseResult prRight = parse_expr(0);
-  ast::Expr * right = nullptr;
-  right = ast::CastCheck<>(right, prRight.ast(), "parse_division ; right");
-  // parse_expr(prev_token_->lbp());
+  ast::Expr *right = parse_expr(prev_lbp());
+  if (failed_) return nullptr;
 
-  pr.ast(new ast::BinOpExpr(left, op, right));
-  return pr;
+  return arena_->New<ast::BinOpExpr>(left, op, right);
 }
 
 // Expr ::= Expr equalEquals Expr
@@ -619,37 +758,31 @@ ParseResult Parser::parse_division(ParseResult prLeft) {
    will depend on what we do in iteration 3 in building an abstract
    syntax tree to decide which method is better.
 */
-ParseResult Parser::parse_relational_expr(ParseResult prLeft) {
+ast::Expr *Parser::parse_relational_expr(ast::Expr *left) {
   // parser has already matchekD left expression
-  ParseResult pr;
-  ast::Expr * left = nullptr;
-  left = ast::CastCheck<>(left, prLeft.ast(), "parse_relational_expr ; left");
-
   next_token();
   // just advance token, since examining it in parse_expr caused
   // this method being called.
-  std::string * op = new std::string(prev_token_->lexeme());
+  const char *op = prev_spelling();
 
-  ParseResult prRight = parse_expr(0);
-  // parse_expr(prev_token_->lbp());
-  ast::Expr * right = nullptr;
-  right = ast::CastCheck<>(right, prRight.ast(),
-                           "parse_relational_expr ; right");
+  ast::Expr *right = parse_expr(prev_lbp());
+  if (failed_) return nullptr;
 
-  pr.ast(new ast::BinOpExpr(left, op, right));
-  return pr;
+  return arena_->New<ast::BinOpExpr>(left, op, right);
 }
 
 // Helper function used by the parser.
 
-void Parser::match(const scanner::TokenType &tt) {
+bool Parser::match(const scanner::TokenType &tt) {
   if (!attempt_match(tt)) {
-    throw(make_error_msg_expected(tt));
+    fail(make_error_msg_expected(tt));
+    return false;
   }
+  return !failed_;
 }
 
 bool Parser::attempt_match(const scanner::TokenType &tt) {
-  if (curr_token_->terminal() == tt) {
+  if (tokens_.terminal(curr_) == tt) {
     next_token();
     return true;
   }
@@ -657,48 +790,66 @@ bool Parser::attempt_match(const scanner::TokenType &tt) {
 }
 
 bool Parser::next_is(const scanner::TokenType &tt) {
-  return curr_token_->terminal() == tt;
+  return tokens_.terminal(curr_) == tt;
 }
 
 void Parser::next_token() {
-  if (curr_token_ == nullptr) {
-    throw(std::string(
-        "Internal Error: should not call nextToken in unitialized state"));
-  } else if (curr_token_->terminal() == scanner::kEndOfFile &&
-           curr_token_->next() == nullptr) {
-    prev_token_ = curr_token_;
-  } else if (curr_token_->terminal() != scanner::kEndOfFile &&
-             curr_token_->next() == nullptr) {
-    throw(make_error_msg("Error: tokens end with endOfFile"));
+  if (streaming_ && tokens_.size() > 0 && curr_ + 1 >= tokens_.size() &&
+      tokens_.terminal(curr_) != scanner::kEndOfFile) {
+    refill_tokens();
+  }
+  bool at_last = curr_ + 1 >= tokens_.size();
+  if (tokens_.size() == 0) {
+    fail("Internal Error: should not call nextToken in unitialized state");
+  } else if (tokens_.terminal(curr_) == scanner::kEndOfFile && at_last) {
+    prev_ = curr_;
+  } else if (tokens_.terminal(curr_) != scanner::kEndOfFile && at_last) {
+    fail(make_error_msg("Error: tokens end with endOfFile"));
   } else {
-    prev_token_ = curr_token_;
-    curr_token_ = curr_token_->next();
+    prev_ = curr_;
+    curr_++;
   }
 }
 
+/// How parse errors refer to a terminal, from its TokenSpec.
 std::string Parser::terminal_description(const scanner::TokenType &terminal) {
-  scanner::Token *dummy_token = new scanner::Token("", terminal, nullptr);
-  scanner::ExtToken *dummy_ext_token = new scanner::ExtToken(this, dummy_token);
-  std::string s =
-  dummy_ext_token->ExtendToken(this, dummy_token)->description();
-  delete dummy_token;
-  delete dummy_ext_token;
-  return s;
+  return scanner::kTokenSpecs[terminal].description;
 }
 
 std::string Parser::make_error_msg_expected(
     const scanner::TokenType &terminal) {
-  std::string s = (std::string) "Expected " + terminal_description(terminal) +
-                  " but found " + curr_token_->description();
+  std::string s = error_location() + "Expected " +
+                  terminal_description(terminal) + " but found " +
+                  terminal_description(tokens_.terminal(curr_));
   return s;
 }
 
 std::string Parser::make_error_msg(const scanner::TokenType &terminal) {
-  std::string s = "Unexpected symbol " + terminal_description(terminal);
+  std::string s = error_location() + "Unexpected symbol " +
+                  terminal_description(terminal);
   return s;
 }
 
 std::string Parser::make_error_msg(const char *msg) { return msg; }
 
+/// Record a syntax error. Only the first one is kept: every production
+/// returns as soon as it sees failed_, so nothing after it is parsed.
+void Parser::fail(const std::string &msg) {
+  if (!failed_) {
+    failed_ = true;
+    error_ = msg;
+  }
+} /* Parser::fail() */
+
+/// "line L, column C: " for the current token. Token offsets are from
+/// the start of the program, in streaming mode too.
+std::string Parser::error_location(void) {
+  int line;
+  int column;
+  lines_.Locate(tokens_.offset(curr_), &line, &column);
+  return "line " + std::to_string(line) + ", column " +
+         std::to_string(column) + ": ";
+}
+
 } /* namespace parser */
 } /* namespace fcal */
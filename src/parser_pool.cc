@@ -0,0 +1,60 @@
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "include/parser_pool.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+namespace fcal {
+namespace parser {
+
+/*******************************************************************************
+ * Constructors/Destructor
+ ******************************************************************************/
+ParserPool::~ParserPool(void) {
+  for (size_t i = 0; i < idle_.size(); i++) {
+    delete idle_[i];
+  } /* for() */
+} /* ~ParserPool() */
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+ParserPool::Lease ParserPool::Acquire(void) {
+  Parser *parser = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!idle_.empty()) {
+      parser = idle_.back();
+      idle_.pop_back();
+    }
+  }
+  if (parser == nullptr) parser = new Parser();
+  return Lease(this, parser);
+} /* Acquire() */
+
+size_t ParserPool::idle(void) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return idle_.size();
+} /* idle() */
+
+/*!
+ * ParserPool::Release() - Take back a parser. It lets go of the source
+ * text and tree of its last parse before it waits for the next thread.
+ */
+void ParserPool::Release(Parser *parser) {
+  parser->streaming(false);
+  parser->Reset();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (idle_.size() < max_idle_) {
+      idle_.push_back(parser);
+      parser = nullptr;
+    }
+  }
+  delete parser;
+} /* Release() */
+
+} /* namespace parser */
+} /* namespace fcal */
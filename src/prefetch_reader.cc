@@ -0,0 +1,102 @@
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <sys/stat.h>
+#include "include/prefetch_reader.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+namespace fcal {
+namespace scanner {
+
+/*******************************************************************************
+ * Constructors/Destructor
+ ******************************************************************************/
+PrefetchReader::PrefetchReader(const std::vector<std::string> &paths,
+                               int num_threads, size_t max_bytes_in_flight)
+    : paths_(paths), max_bytes_in_flight_(max_bytes_in_flight), mutex_(),
+      ready_changed_(), space_freed_(), ready_(), next_path_(0),
+      handed_out_(0), bytes_in_flight_(0), stopping_(false), threads_() {
+  if (num_threads < 1) num_threads = 1;
+  for (int i = 0; i < num_threads; i++) {
+    threads_.push_back(std::thread(&PrefetchReader::Load, this));
+  } /* for() */
+} /* PrefetchReader() */
+
+PrefetchReader::~PrefetchReader(void) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  space_freed_.notify_all();
+  for (size_t i = 0; i < threads_.size(); i++) {
+    threads_[i].join();
+  } /* for() */
+  for (size_t i = 0; i < ready_.size(); i++) {
+    delete ready_[i].first.second;
+  } /* for() */
+} /* ~PrefetchReader() */
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+bool PrefetchReader::Next(int *index, std::unique_ptr<InputBuffer> *input) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (ready_.empty() && handed_out_ < paths_.size()) {
+    ready_changed_.wait(lock);
+  } /* while() */
+  if (ready_.empty()) return false;
+
+  *index = ready_.front().first.first;
+  input->reset(ready_.front().first.second);
+  bytes_in_flight_ -= ready_.front().second;
+  ready_.pop_front();
+  handed_out_++;
+  lock.unlock();
+  space_freed_.notify_all();
+  return true;
+} /* Next() */
+
+/*!
+ * PrefetchReader::Load() - The body of each I/O thread. Claim the next
+ * file, wait until its size fits under the limit, and load it. The size
+ * is taken from stat() beforehand so that the space is reserved before
+ * any memory is used; a file that cannot be stat'ed counts as empty.
+ * Like the load itself, stat() is called without the lock, since on a
+ * slow file system it would hold up every other thread.
+ */
+void PrefetchReader::Load(void) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!stopping_ && next_path_ < paths_.size()) {
+    int index = static_cast<int>(next_path_++);
+
+    lock.unlock();
+    struct stat filestatus;
+    size_t size = 0;
+    if (stat(paths_[index].c_str(), &filestatus) == 0) {
+      size = filestatus.st_size;
+    }
+    lock.lock();
+
+    while (!stopping_ && bytes_in_flight_ > 0 &&
+           bytes_in_flight_ + size > max_bytes_in_flight_) {
+      space_freed_.wait(lock);
+    } /* while() */
+    if (stopping_) break;
+    bytes_in_flight_ += size;
+
+    lock.unlock();
+    InputBuffer *input = new InputBuffer();
+    input->Open(paths_[index].c_str());
+    lock.lock();
+
+    ready_.push_back(std::make_pair(Loaded(index, input), size));
+    ready_changed_.notify_all();
+  } /* while() */
+  // Wake any consumer waiting on a file this thread will not load.
+  ready_changed_.notify_all();
+} /* Load() */
+
+} /* namespace scanner */
+} /* namespace fcal */
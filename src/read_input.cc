@@ -1,10 +1,16 @@
 /*******************************************************************************
  * Includes
  ******************************************************************************/
+#include <errno.h>
+#include <fcntl.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <unistd.h>
+#include "include/read_input.h"
 
 /*******************************************************************************
  * Namespaces
@@ -12,51 +18,204 @@
 namespace fcal {
 namespace scanner {
 
+/*******************************************************************************
+ * Constant Definitions
+ ******************************************************************************/
+/// The least each read from a pipe asks for. Pipes hand over at most
+/// their own buffer per read, so this only needs to be comfortably
+/// larger than that.
+static const size_t kReadBlock = 256 * 1024;
+
+/*******************************************************************************
+ * Helper Functions
+ ******************************************************************************/
+/*!
+ * ReadAll() - Read fd to its end into a null terminated buffer from
+ * new[]. Each read goes straight into the free space at the end of the
+ * buffer, which at least doubles each time it fills, so a stream of
+ * unknown length is copied at most once more in total.
+ * size_hint is the expected length, or 0 for a pipe.
+ *
+ * RETURN:
+ *     char* - The buffer, or nullptr if a read failed. The length of
+ *             the text is stored in length.
+ */
+static char *ReadAll(int fd, size_t size_hint, size_t *length) {
+  size_t capacity = size_hint > 0 ? size_hint + 1 : kReadBlock;
+  char *buffer = new char[capacity];
+  size_t done = 0;
+  for (;;) {
+    ssize_t count;
+    if (done + 1 < capacity) {
+      count = read(fd, buffer + done, capacity - 1 - done);
+    } else {
+      // The buffer is full. Look for one more byte before growing it,
+      // so a file whose size was known is never copied.
+      char extra;
+      count = read(fd, &extra, 1);
+      if (count > 0) {
+        size_t grown = capacity * 2 < capacity + kReadBlock ?
+            capacity + kReadBlock : capacity * 2;
+        char *bigger = new char[grown];
+        memcpy(bigger, buffer, done);
+        delete [] buffer;
+        buffer = bigger;
+        capacity = grown;
+        buffer[done] = extra;
+      }
+    }
+    // A signal, such as SIGCHLD, may interrupt either read before it
+    // reads anything; that is not a failure, so it is tried again.
+    if (count < 0 && errno == EINTR) continue;
+    if (count < 0) {
+      delete [] buffer;
+      return nullptr;
+    }
+    if (count == 0) break;
+    done += count;
+  } /* for() */
+  buffer[done] = '\0';
+  *length = done;
+  return buffer;
+} /* ReadAll() */
+
+/// The size of a regular file open on fd, or 0 for anything else.
+static size_t RegularFileSize(int fd, bool *regular) {
+  struct stat filestatus;
+  *regular = fstat(fd, &filestatus) == 0 && S_ISREG(filestatus.st_mode);
+  return *regular ? filestatus.st_size : 0;
+} /* RegularFileSize() */
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+bool InputBuffer::Open(const char *filename) {
+  Close();
+  int fd = open(filename, O_RDONLY);
+  if (fd < 0) {
+    printf("File \"%s\" not found.\n", filename);
+    fflush(stdout);
+    return false;
+  }
+
+  bool ok = Load(fd);
+  close(fd);
+
+  if (!ok) {
+    printf("File \"%s\" could not be read.\n", filename);
+    fflush(stdout);
+  }
+  return ok;
+} /* Open() */
+
+bool InputBuffer::Open(int fd) {
+  Close();
+  return Load(fd);
+} /* Open() */
+
+void InputBuffer::Close(void) {
+  if (mapped_) {
+    munmap(text_, mapping_);
+  } else {
+    delete [] text_;
+  }
+  text_ = nullptr;
+  size_ = 0;
+  mapping_ = 0;
+  mapped_ = false;
+} /* Close() */
+
+/// Map a large regular file, and read anything else to its end.
+bool InputBuffer::Load(int fd) {
+  bool regular;
+  size_t size = RegularFileSize(fd, &regular);
+  if (regular && size >= kMapThreshold) return Map(fd, size);
+
+  text_ = ReadAll(fd, size, &size_);
+  return text_ != nullptr;
+} /* Load() */
+
+/*!
+ * InputBuffer::Map() - Map the file behind a page of zeros.
+ *
+ * Anonymous zero pages are reserved for the whole file plus one page,
+ * and the file is mapped over all but the last of them. The kernel
+ * fills the rest of the file's last page with zeros, and the reserved
+ * page after it supplies the terminating null when the file ends
+ * exactly on a page boundary.
+ */
+bool InputBuffer::Map(int fd, size_t size) {
+  size_t page = sysconf(_SC_PAGESIZE);
+  size_t file_pages = (size + page - 1) / page * page;
+  size_t mapping = file_pages + page;
+
+  void *base = mmap(nullptr, mapping, PROT_READ,
+                    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (base == MAP_FAILED) return false;
+  if (mmap(base, file_pages, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0) ==
+      MAP_FAILED) {
+    munmap(base, mapping);
+    return false;
+  }
+  // The scanner reads the text from start to end.
+  madvise(base, file_pages, MADV_SEQUENTIAL);
+
+  text_ = static_cast<char *>(base);
+  size_ = size;
+  mapping_ = mapping;
+  mapped_ = true;
+  return true;
+} /* Map() */
+
 /*******************************************************************************
  * Functions
  ******************************************************************************/
 /**
- * ReadInputFromFile() - Do the actual reading of the file into the buffer
+ * ReadInputFromFile() - Do the actual reading of the file into the buffer.
+ * The caller owns the buffer; InputBuffer frees its text itself and maps
+ * large files instead of copying them. Named pipes and devices such as
+ * /dev/stdin are read to their end.
  *
  * RETURN:
  *     char* - The buffer, or nullptr if an error occurred.
  **/
 char *ReadInputFromFile(const char *filename) {
-  FILE *in_fp;
-  in_fp = fopen(filename, "r");
+  int fd = open(filename, O_RDONLY);
 
-  if (in_fp == nullptr) {
+  if (fd < 0) {
     printf("File \"%s\" not found.\n", filename);
     fflush(stdout);
     return nullptr;
   }
 
-  // Determine the size of the file, used to allocate the char buffer.
-  struct stat filestatus;
-  stat(filename, &filestatus);
-
-  int filesize = filestatus.st_size + 1;  // +1 for terminating null char
-
-  // Allocate space for the character buffer.
-  char *buffer = new char[filesize];
-
-  int index = 0;
-  char ch = getc(in_fp);
-
-  while (ch != EOF) {
-    buffer[index] = ch;
-    index++;
-    ch = getc(in_fp);
-  }
-  buffer[index] = '\0';
+  // Size the buffer from the file when it is a regular one.
+  bool regular;
+  size_t length;
+  char *buffer = ReadAll(fd, RegularFileSize(fd, &regular), &length);
+  close(fd);
 
   return buffer;
 } /* ReadInputFromFile() */
 
+/**
+ * ReadInputFromStdin() - Read standard input to its end, so that FCAL
+ * can be piped in from another program. The calling function is
+ * responsible for disposing of the return memory.
+ *
+ * RETURN:
+ *     char* - The buffer, or nullptr if an error occurred.
+ **/
+char *ReadInputFromStdin(void) {
+  bool regular;
+  size_t length;
+  return ReadAll(STDIN_FILENO, RegularFileSize(STDIN_FILENO, &regular),
+                 &length);
+} /* ReadInputFromStdin() */
 
 /**
  * ReadInput() - Read a file into a char buffer. The calling function is
- * responsible for disposing of the return memory.
+ * responsible for disposing of the return memory. A file name of "-"
+ * reads standard input.
  *
  * RETURN:
  *     char* - The buffer, or nullptr if an error occurred.
@@ -67,6 +226,8 @@ char *ReadInput(int argc, char **argv) {
   if (argc <= 1) {
     //        printf ("Usage: %s <filename>\n", argv[0]) ;
     return nullptr;
+  } else if (strcmp(argv[1], "-") == 0) {
+    return ReadInputFromStdin();
   } else {
     return ReadInputFromFile(argv[1]);
   }
@@ -31,6 +31,7 @@ regex_t* make_regex(const char* pattern) {
     std::size_t length = regerror(rc, re, nullptr, 0);
     char *buffer = new char[length];
     (void) regerror(rc, re, buffer, length);
+    delete [] buffer;
     delete re;
     return nullptr;
   } else {
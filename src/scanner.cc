@@ -1,107 +1,324 @@
+#include <limits.h>
+#include <stdint.h>
+#include <string.h>
 #include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "include/lexer.h"
+#include "include/lexer_tables.h"
 #include "include/regex.h"
 #include "include/scanner.h"
 #include "include/token.h"
+#include "include/whitespace.h"
 
 namespace fcal {
 namespace scanner {
-// Create the compiled regular expressions for future use
-regex_t * white_space = make_regex("^[\n\t\r ]+");
-regex_t * block_comment = make_regex("^/\\*([^\\*]|\\*+[^\\*/])*\\*+/");
-regex_t * line_comment = make_regex("^//[^\n]*\n");
-
-int consume_whitespace_and_comments(regex_t *white_space,
-regex_t *block_comment, regex_t *line_comment, const char *text);
+/*!
+ * Scan the whole program into a contiguous token
+ * stream. Each token is recorded as its terminal,
+ * offset and length; nothing is allocated per token.
+ */
+void Scanner::Scan(const char *text, TokenStream *tokens) {
+    tokens->Reset(text);
+    /*!
+     * There is always an end of file token, so
+     * the scan stops there rather than at a count.
+     */
+    ScanNext(text, 0, INT_MAX, tokens);
+} /* scan(const char *, TokenStream *) */
 
-Token * Scanner::Scan(const char *text) {
+/*!
+ * Scan tokens from offset until count of them have
+ * been appended or the next token would start at or
+ * after end. Returns the offset of that next token
+ * (after white space and comments), or of the end of
+ * the text once the end of file token is appended.
+ */
+static int ScanTokens(const char *source, int offset, int count, int end,
+  TokenStream *tokens) {
+    const char *text = source + offset;
+    SymbolTable *symbol_table = tokens->symbol_table();
+    TokenType terminal_type;
     int num_matched_chars;
 
     /*!
-     * Scanned objects will be represented as
-     * having a head, body and tail to represent
-     * subsequent scanning of tokens in an 
-     * intuitive manner.
+     * Get rid of white spaces and comments
      */
-    Token * head = nullptr;
-    Token * body = nullptr;
-    Token * tail = nullptr;
+    num_matched_chars = SkipWhitespaceAndComments(text);
+    text += num_matched_chars;
+
+    for (int i = 0; i < count && text - source < end; i++) {
+        if (text[0] == '\0') {
+            /*!
+             * Add an end of file token at the end. Its
+             * empty lexeme sits on the terminating null.
+             */
+            tokens->Append(kEndOfFile, static_cast<int>(text - source), 0,
+  -1);
+            break;
+        }
+        /*!
+         *  Match the next token and append it
+         */
+        num_matched_chars = MatchToken(text, &terminal_type);
+        int symbol = -1;
+        if (terminal_type == kVariableName && symbol_table != nullptr) {
+            symbol = symbol_table->Intern(text, num_matched_chars);
+        }
+        tokens->Append(terminal_type, static_cast<int>(text - source),
+  num_matched_chars, symbol);
+        text += num_matched_chars;
+        num_matched_chars = SkipWhitespaceAndComments(text);
+        text += num_matched_chars;
+    }
+    return static_cast<int>(text - source);
+} /* ScanTokens() */
+
+/*!
+ * Scan the next few tokens of a program. This is
+ * what lets the parser pull tokens on demand
+ * instead of scanning the whole program first.
+ */
+int Scanner::ScanNext(const char *source, int offset, int count,
+  TokenStream *tokens) {
+    return ScanTokens(source, offset, count, INT_MAX, tokens);
+} /* ScanNext() */
+
+/*!
+ * Pick where to split text into at most num_chunks
+ * pieces of about the same size. Each split is put
+ * on a newline, where a token is unlikely to be
+ * open. The result starts with 0 and each chunk
+ * runs from one entry to the next.
+ */
+static std::vector<int> SplitPoints(const char *text, int length,
+  int num_chunks) {
+    std::vector<int> bounds(1, 0);
+    for (int k = 1; k < num_chunks; k++) {
+        int target = static_cast<int>(
+            static_cast<int64_t>(length) * k / num_chunks);
+        if (target <= bounds.back()) target = bounds.back() + 1;
+        if (target >= length) break;
+        const char *newline = static_cast<const char *>(
+            memchr(text + target, '\n', length - target));
+        if (newline == nullptr) break;
+        bounds.push_back(static_cast<int>(newline - text));
+    }
+    return bounds;
+} /* SplitPoints() */
+
+/*!
+ * Scan a program on several threads. Each chunk is
+ * scanned as if a token started at its first
+ * character, keeping the tokens that start before
+ * the next chunk. A split can still land inside a
+ * string constant or a comment, so the chunks are
+ * checked in order while they are stitched together:
+ * a chunk's tokens are only used from the first one
+ * that starts exactly where the tokens kept so far
+ * end. Up to that point the text is scanned again,
+ * one token at a time, as the sequential scan would.
+ */
+void Scanner::ScanParallel(const char *text, TokenStream *tokens,
+  int num_chunks) {
+    int length = static_cast<int>(strlen(text));
+    std::vector<int> bounds = SplitPoints(text, length, num_chunks);
+    int n = static_cast<int>(bounds.size());
+    if (n == 1) {
+        Scan(text, tokens);
+        return;
+    }
+    bounds.push_back(INT_MAX);
 
     /*!
-     * Get rid of white spaces and comments
+     * Each chunk interns names into a table of its
+     * own, so that hashing also runs in parallel.
      */
-    num_matched_chars =
-    consume_whitespace_and_comments(white_space,
-  block_comment, line_comment, text);
-    text += num_matched_chars;
+    SymbolTable *symbol_table = tokens->symbol_table();
+    std::unique_ptr<TokenStream[]> chunks(new TokenStream[n]);
+    std::unique_ptr<SymbolTable[]> chunk_symbols(new SymbolTable[n]);
+    std::vector<int> ends(n);
+    auto scan_chunk = [&](int k) {
+        chunks[k].Reset(text);
+        if (symbol_table != nullptr) {
+            chunks[k].symbol_table(&chunk_symbols[k]);
+        }
+        ends[k] = ScanTokens(text, bounds[k], INT_MAX, bounds[k + 1],
+  &chunks[k]);
+    };
+    std::vector<std::thread> threads;
+    for (int k = 1; k < n; k++) {
+        threads.push_back(std::thread(scan_chunk, k));
+    }
+    scan_chunk(0);
+    for (size_t t = 0; t < threads.size(); t++) {
+        threads[t].join();
+    }
+
+    /*!
+     * Stitch the chunks together. pos is where the
+     * sequential scan would find its next token.
+     */
+    tokens->Reset(text);
+    int total = 0;
+    for (int k = 0; k < n; k++) total += chunks[k].size();
+    tokens->Reserve(total);
+    int pos = SkipWhitespaceAndComments(text);
+    for (int k = 0; k < n; k++) {
+        const TokenStream &chunk = chunks[k];
+        int i = 0;
+        bool in_step = false;
+        while (!in_step && pos < bounds[k + 1]) {
+            while (i < chunk.size() && chunk.offset(i) < pos) i++;
+            in_step = i < chunk.size() ? chunk.offset(i) == pos
+                                       : ends[k] == pos;
+            if (!in_step) {
+                pos = ScanTokens(text, pos, 1, INT_MAX, tokens);
+                if (tokens->terminal(tokens->size() - 1) == kEndOfFile) {
+                    return;
+                }
+            }
+        }
+        if (!in_step) continue;
 
-    while (text[0] != '\0') {
         /*!
-         *  Match the next token and make it the tail
+         * Renumber the chunk's symbols in the order the
+         * sequential scan would have first met them.
          */
-        tail = token_iterator(text);
-        if (head != nullptr) {
-            /*!
-             * Move the body pointer along to the tail
-             * in preparation for the next token to 
-             * be scanned.
-             */
-            body->set_next_(tail);
-            body = tail;
+        std::vector<int> symbols(chunk_symbols[k].size(), -1);
+        for (; i < chunk.size(); i++) {
+            int symbol = chunk.symbol(i);
+            if (symbol >= 0) {
+                if (symbols[symbol] < 0) {
+                    symbols[symbol] = symbol_table->Intern(chunk.text(i),
+  chunk.length(i));
+                }
+                symbol = symbols[symbol];
+            }
+            tokens->Append(chunk.terminal(i), chunk.offset(i),
+  chunk.length(i), symbol);
+        }
+        pos = ends[k];
+    }
+} /* ScanParallel() */
+
+/*!
+ * The index of the first token that starts at or
+ * after offset, found by binary search.
+ */
+static int FirstTokenAt(const TokenStream &tokens, int offset) {
+    int lo = 0;
+    int hi = tokens.size();
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (tokens.offset(mid) < offset) {
+            lo = mid + 1;
         } else {
-            /*!
-             * Initial case for the first token scanned.
-             * Head, body and tail all point to the same
-             * token.
-             */
-            head = tail;
-            body = tail;
+            hi = mid;
         }
-        text += body->lexeme().length();
-        num_matched_chars =
-  consume_whitespace_and_comments(white_space,
-  block_comment, line_comment, text);
-        text += num_matched_chars;
     }
+    return lo;
+} /* FirstTokenAt() */
+
+/*!
+ * Bring a scan up to date after an edit. Matching a
+ * token only looks at its own characters and the
+ * one after it, unless it is open (see TokenStream),
+ * so the tokens before the last one starting ahead
+ * of the edit, and before the first open token, are
+ * unchanged. Scanning restarts there and stops at
+ * the first new token that starts exactly where an
+ * old token after the edit started, moved by the
+ * change in length: the text from there on is the
+ * same, so the old tokens from there on are too.
+ */
+void Scanner::Rescan(const char *text, int begin, int old_length,
+  int new_length, TokenStream *tokens) {
+    int end = begin + old_length;
+    int shift = new_length - old_length;
+
     /*!
-     * Add an end of file token at the end.
+     * Find the first token that may have changed
+     * and the offset to start scanning from.
      */
-    tail = new Token(kEndOfFile, "kEndOfFile", nullptr);
+    int first = 0;
+    int start = 0;
+    int before = FirstTokenAt(*tokens, begin);
+    if (before > 0) {
+        first = before - 1;
+        start = tokens->offset(first);
+    }
+    int open = tokens->first_open();
+    if (open >= 0 && open < start) {
+        first = FirstTokenAt(*tokens, open);
+        start = open;
+    }
+
+    /*!
+     * Scan new tokens until one lines up with an old
+     * token after the edit, or the text ends.
+     */
+    TokenStream fresh;
+    fresh.Reset(text);
+    fresh.symbol_table(tokens->symbol_table());
+    int last = first;
+    int pos = SkipWhitespaceAndComments(text + start) + start;
+    for (;;) {
+        if (pos - shift >= end) {
+            while (last < tokens->size() &&
+                   tokens->offset(last) < pos - shift) {
+                last++;
+            }
+            if (last < tokens->size() && tokens->offset(last) == pos - shift) {
+                break;
+            }
+        }
+        pos = ScanTokens(text, pos, 1, INT_MAX, &fresh);
+        if (fresh.terminal(fresh.size() - 1) == kEndOfFile) {
+            last = tokens->size();
+            break;
+        }
+    }
+    tokens->Splice(first, last, fresh, shift);
+} /* Rescan() */
+
+/*!
+ * Scan the whole program into a linked list of
+ * tokens, for callers that walk the list through
+ * Token::next().
+ */
+Token * Scanner::Scan(const char *text) {
+    TokenStream tokens;
+    Scan(text, &tokens);
 
-    if (head == nullptr) {
-        return tail;
+    /*!
+     * Build the list back to front so each
+     * token can be linked as it is created.
+     */
+    Token * head = nullptr;
+    for (int i = tokens.size() - 1; i >= 0; i--) {
+        head = new Token(tokens.terminal(i), tokens.text(i),
+  tokens.length(i), head);
     }
-    body->set_next_(tail);
     return head;
 } /* scan(const char *) */
 
 /*!
  * An iterator method to find
- * the next token.
+ * the next token. The token kind and length
+ * come from the single-pass state machine in
+ * MatchToken(), which agrees with the longest
+ * match over token_regex.
  */
 Token * Scanner::token_iterator(const char *text) {
-    int terminal_type;
-    int max_matched = int();  // zero-initialized
-    std::string lexeme;
+    TokenType terminal_type;
+    int max_matched = MatchToken(text, &terminal_type);
     Token * next_token;
 
-    for (int i = kIntKwd; i < kLexicalError+1; i++) {
-        /*!
-         * Perform checks to identify which regular expression
-         * the current token should be matched to. Done by
-         * comparing lengths of attempting matches for each
-         * possible regular expression.
-         */ 
-        if (max_matched < match_regex(get_regex(i), text)) {
-            terminal_type = i;
-            max_matched = match_regex(get_regex(i), text);
-  // Usage : string& assign (const char* s, size_t n);
-  // Copies the first n characters from the array of characters pointed by s.
-            lexeme.assign(text, match_regex(get_regex(i), text));
-        }
-    }
-    // static_cast -> int to enum type casting
-    next_token = new Token(static_cast<TokenType>(terminal_type),
- lexeme, nullptr);
+    // The token refers to the matched characters in place; nothing
+    // is copied until someone asks for the lexeme.
+    next_token = new Token(terminal_type, text, max_matched, nullptr);
     return next_token;
 }
 
@@ -142,5 +359,11 @@ int consume_whitespace_and_comments(regex_t *white_space,
   return total_num_matched_chars;
 } /* consume_whitespace_and_comments() */
 
+int consume_whitespace_and_comments(const char *text) {
+  const LexerTables &tables = LexerTables::Get();
+  return consume_whitespace_and_comments(tables.white_space(),
+  tables.block_comment(), tables.line_comment(), text);
+} /* consume_whitespace_and_comments(const char *) */
+
 }  // namespace scanner
 }  // namespace fcal
@@ -0,0 +1,81 @@
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <string.h>
+#include "include/symbol_table.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+namespace fcal {
+namespace scanner {
+
+/*******************************************************************************
+ * Constant Definitions
+ ******************************************************************************/
+/// Number of slots in a new table.
+static const int kInitialSlots = 64;
+
+/*******************************************************************************
+ * Helper Functions
+ ******************************************************************************/
+/// FNV-1a hash of the length characters at text.
+static unsigned Hash(const char *text, int length) {
+  unsigned hash = 2166136261u;
+  for (int i = 0; i < length; i++) {
+    hash ^= static_cast<unsigned char>(text[i]);
+    hash *= 16777619u;
+  }
+  return hash;
+} /* Hash() */
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+int SymbolTable::Intern(const char *text, int length) {
+  if (2 * (size() + 1) > static_cast<int>(slots_.size())) {
+    Rehash(slots_.empty() ? kInitialSlots : 2 * slots_.size());
+  }
+
+  unsigned hash = Hash(text, length);
+  unsigned mask = slots_.size() - 1;
+  for (unsigned slot = hash & mask;; slot = (slot + 1) & mask) {
+    int symbol = slots_[slot];
+    if (symbol < 0) {
+      symbol = size();
+      names_.push_back(std::string(text, length));
+      hashes_.push_back(hash);
+      slots_[slot] = symbol;
+      return symbol;
+    }
+    const std::string &name = names_[symbol];
+    if (hashes_[symbol] == hash &&
+        static_cast<int>(name.size()) == length &&
+        memcmp(name.data(), text, length) == 0) {
+      return symbol;
+    }
+  } /* for() */
+} /* Intern() */
+
+void SymbolTable::Clear(void) {
+  names_.clear();
+  hashes_.clear();
+  slots_.assign(slots_.size(), -1);
+} /* Clear() */
+
+/*!
+ * Rehash() - Spread the symbols over a new table of capacity slots,
+ * using the hashes saved when they were interned.
+ */
+void SymbolTable::Rehash(int capacity) {
+  slots_.assign(capacity, -1);
+  unsigned mask = capacity - 1;
+  for (int symbol = 0; symbol < size(); symbol++) {
+    unsigned slot = hashes_[symbol] & mask;
+    while (slots_[slot] >= 0) slot = (slot + 1) & mask;
+    slots_[slot] = symbol;
+  } /* for() */
+} /* Rehash() */
+
+} /* namespace scanner */
+} /* namespace fcal */
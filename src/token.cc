@@ -14,22 +14,20 @@ namespace scanner {
  * Functions
  ******************************************************************************/
   Token::Token() {
+     this->text_ = "";
+     this->length_ = 0;
      this->next_ = nullptr;
   } /* Token() */
 
   Token::~Token() {} /* ~Token() */
 
-  Token::Token(TokenType terminal, std::string lexeme, Token * next) {
+  Token::Token(TokenType terminal, const char * text, int length,
+               Token * next) {
     terminal_ = terminal;
-    lexeme_ = lexeme;
+    text_ = text;
+    length_ = length;
     next_ = next;
-  } /* Token(TokenType, std::string, Token *) */
-
-  Token::Token(std::string lexeme, TokenType terminal, Token * next) {
-  lexeme_ = lexeme;
-  terminal_ = terminal;
-  next_ = next;
-  } /* Token(std::string, TokenType, Token) */
+  } /* Token(TokenType, const char *, int, Token *) */
 
   TokenType Token::terminal() {
     /* Return terminal_ value */
@@ -37,10 +35,20 @@ namespace scanner {
   } /* get_terminal_() */
 
   std::string Token::lexeme() {
-    /* Return lexeme_ value */
-    return this->lexeme_;
+    /* Copy the lexeme out of the scanned text */
+    return std::string(this->text_, this->length_);
   } /* get_lexeme_() */
 
+  const char * Token::text() {
+    /* Return a pointer to the start of the lexeme in the scanned text */
+    return this->text_;
+  } /* text() */
+
+  int Token::length() {
+    /* Return the number of characters in the lexeme */
+    return this->length_;
+  } /* length() */
+
   Token * Token::next() {
     /* Return a pointer to the next token */
     return this->next_;
@@ -52,9 +60,10 @@ namespace scanner {
     return;
   } /* set_terminal_() */
 
-  void Token::set_lexeme_(std::string new_lexeme) {
-    /* Set the lexeme_ to a new value */
-    this->lexeme_ = new_lexeme;
+  void Token::set_lexeme_(const char * new_text, int new_length) {
+    /* Point the lexeme at a new span of text */
+    this->text_ = new_text;
+    this->length_ = new_length;
     return;
   } /* set_lexeme() */
 
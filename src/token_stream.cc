@@ -0,0 +1,126 @@
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <string.h>
+#include "include/token_stream.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+namespace fcal {
+namespace scanner {
+
+/*******************************************************************************
+ * Constant Definitions
+ ******************************************************************************/
+/// Bytes used by one token across the offset, length, symbol and terminal
+/// columns.
+static const int kBytesPerToken = 3 * sizeof(int) + sizeof(unsigned char);
+
+/// Number of tokens the first block has room for.
+static const int kInitialCapacity = 256;
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+TokenStream::~TokenStream(void) {
+  delete [] block_;
+} /* ~TokenStream() */
+
+void TokenStream::Reset(const char *source) {
+  source_ = source;
+  size_ = 0;
+  first_open_ = -1;
+} /* Reset() */
+
+void TokenStream::Discard(int count) {
+  if (count <= 0) return;
+  size_ -= count;
+  memmove(offsets_, offsets_ + count, size_ * sizeof(int));
+  memmove(lengths_, lengths_ + count, size_ * sizeof(int));
+  memmove(symbols_, symbols_ + count, size_ * sizeof(int));
+  memmove(terminals_, terminals_ + count, size_);
+} /* Discard() */
+
+void TokenStream::Splice(int first, int last, const TokenStream &replacement,
+                         int shift) {
+  // Where the first open token is, before anything moves. Only the first
+  // is known, so if it is being replaced the tail has to be searched.
+  bool open_in_prefix = first_open_ >= 0 &&
+                        (first == size_ || first_open_ < offsets_[first]);
+  bool open_in_tail = first_open_ >= 0 && last < size_ &&
+                      first_open_ >= offsets_[last];
+  bool open_replaced = first_open_ >= 0 && !open_in_prefix && !open_in_tail;
+
+  int tail = size_ - last;
+  int new_size = first + replacement.size_ + tail;
+  if (new_size > capacity_) Grow(new_size);
+
+  // Move the tail into place, then copy the replacement in front of it.
+  int to = first + replacement.size_;
+  memmove(offsets_ + to, offsets_ + last, tail * sizeof(int));
+  memmove(lengths_ + to, lengths_ + last, tail * sizeof(int));
+  memmove(symbols_ + to, symbols_ + last, tail * sizeof(int));
+  memmove(terminals_ + to, terminals_ + last, tail);
+  for (int i = to; i < new_size; i++) offsets_[i] += shift;
+
+  int count = replacement.size_;
+  if (count > 0) {
+    memcpy(offsets_ + first, replacement.offsets_, count * sizeof(int));
+    memcpy(lengths_ + first, replacement.lengths_, count * sizeof(int));
+    memcpy(symbols_ + first, replacement.symbols_, count * sizeof(int));
+    memcpy(terminals_ + first, replacement.terminals_, count);
+  }
+
+  size_ = new_size;
+  source_ = replacement.source_;
+  if (open_in_prefix) return;
+
+  if (replacement.first_open_ >= 0) {
+    first_open_ = replacement.first_open_;
+  } else if (open_in_tail) {
+    first_open_ += shift;
+  } else {
+    first_open_ = -1;
+    for (int i = to; open_replaced && i < size_ && first_open_ < 0; i++) {
+      if (terminals_[i] == kLexicalError || terminals_[i] == kForwardSlash) {
+        NoteOpen(offsets_[i]);
+      }
+    } /* for() */
+  }
+} /* Splice() */
+
+/*!
+ * Grow() - Move the columns into a block with room for at least
+ * min_capacity tokens. The int columns come first so that they stay
+ * aligned; the terminal bytes are packed at the end.
+ */
+void TokenStream::Grow(int min_capacity) {
+  int capacity = capacity_ ? capacity_ : kInitialCapacity;
+  while (capacity < min_capacity) capacity *= 2;
+
+  char *block = new char[capacity * kBytesPerToken];
+  int *offsets = reinterpret_cast<int *>(block);
+  int *lengths = offsets + capacity;
+  int *symbols = lengths + capacity;
+  unsigned char *terminals = reinterpret_cast<unsigned char *>(
+      symbols + capacity);
+
+  if (size_ > 0) {
+    memcpy(offsets, offsets_, size_ * sizeof(int));
+    memcpy(lengths, lengths_, size_ * sizeof(int));
+    memcpy(symbols, symbols_, size_ * sizeof(int));
+    memcpy(terminals, terminals_, size_);
+  }
+  delete [] block_;
+
+  block_ = block;
+  offsets_ = offsets;
+  lengths_ = lengths;
+  symbols_ = symbols;
+  terminals_ = terminals;
+  capacity_ = capacity;
+} /* Grow() */
+
+} /* namespace scanner */
+} /* namespace fcal */
@@ -0,0 +1,185 @@
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <stdint.h>
+#include "include/whitespace.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+namespace fcal {
+namespace scanner {
+
+/*******************************************************************************
+ * Helper Functions
+ ******************************************************************************/
+static inline bool IsSpace(char c) {
+  return c == ' ' || c == '\n' || c == '\t' || c == '\r';
+}
+
+// The aligned loads below may read bytes past the terminating null, but
+// never past the page it is on. The sanitizers cannot tell that apart
+// from a real overflow, so they are told not to check these functions.
+#if defined(__SSE2__) && defined(__GNUC__)
+#define FCAL_NO_SANITIZE_MEMORY \
+    __attribute__((no_sanitize("address", "thread")))
+#else
+#define FCAL_NO_SANITIZE_MEMORY
+#endif
+
+#ifdef __SSE2__
+/// Bytes covered by one SSE2 register.
+static const int kVectorBytes = 16;
+
+/// Mask of the bytes in chunk equal to c.
+static inline int MatchMask(__m128i chunk, char c) {
+  return _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(c)));
+}
+
+/// Load the aligned 16 byte block holding p, and return how many of its
+/// bytes come before p.
+FCAL_NO_SANITIZE_MEMORY
+static inline __m128i LoadBlock(const char *p, const char **block,
+                                int *skip) {
+  uintptr_t address = reinterpret_cast<uintptr_t>(p);
+  *skip = static_cast<int>(address & (kVectorBytes - 1));
+  *block = p - *skip;
+  return _mm_load_si128(reinterpret_cast<const __m128i *>(*block));
+}
+
+/// Index of the lowest set bit of a non-zero mask.
+static inline int LowestBit(int mask) { return __builtin_ctz(mask); }
+#endif
+
+/*!
+ * SkipSpaceRun() - Return the first character at or after p that is not
+ * white space. The terminating null always stops the run.
+ */
+FCAL_NO_SANITIZE_MEMORY
+static const char *SkipSpaceRun(const char *p) {
+#ifdef __SSE2__
+  const char *block;
+  int skip;
+  __m128i chunk = LoadBlock(p, &block, &skip);
+  for (;;) {
+    int space = MatchMask(chunk, ' ') | MatchMask(chunk, '\n') |
+                MatchMask(chunk, '\t') | MatchMask(chunk, '\r');
+    // Treat the bytes before p as white space so they are passed over.
+    space |= (1 << skip) - 1;
+    if (space != 0xFFFF) return block + LowestBit(~space & 0xFFFF);
+    block += kVectorBytes;
+    skip = 0;
+    chunk = _mm_load_si128(reinterpret_cast<const __m128i *>(block));
+  }
+#else
+  while (IsSpace(*p)) ++p;
+  return p;
+#endif
+} /* SkipSpaceRun() */
+
+/*!
+ * FindBlockCommentEnd() - Return the "*" of the first "*" "/" pair that
+ * starts at or after p, or nullptr if the text ends first.
+ *
+ * The block comment pattern is written with [^\\*], which in a POSIX
+ * bracket expression excludes the backslash as well as the star, so a
+ * backslash before the closing pair also means there is no comment.
+ */
+FCAL_NO_SANITIZE_MEMORY
+static const char *FindBlockCommentEnd(const char *p) {
+#ifdef __SSE2__
+  const char *block;
+  int skip;
+  __m128i chunk = LoadBlock(p, &block, &skip);
+  int valid = 0xFFFF & ~((1 << skip) - 1);
+  bool star_carry = false;  // the last byte of the previous block was '*'
+  for (;;) {
+    int star = MatchMask(chunk, '*') & valid;
+    int slash = MatchMask(chunk, '/') & valid;
+    int stop = (MatchMask(chunk, '\0') | MatchMask(chunk, '\\')) & valid;
+    // Only bytes before the null or backslash can close the comment.
+    int limit = stop ? (1 << LowestBit(stop)) - 1 : 0xFFFF;
+    star &= limit;
+    slash &= limit;
+
+    if (star_carry && (slash & 1)) return block - 1;
+    int pairs = star & (slash >> 1);
+    if (pairs) return block + LowestBit(pairs);
+    if (stop) return nullptr;
+
+    star_carry = (star & 0x8000) != 0;
+    block += kVectorBytes;
+    valid = 0xFFFF;
+    chunk = _mm_load_si128(reinterpret_cast<const __m128i *>(block));
+  }
+#else
+  for (; *p != '\0' && *p != '\\'; ++p) {
+    if (p[0] == '*' && p[1] == '/') return p;
+  }
+  return nullptr;
+#endif
+} /* FindBlockCommentEnd() */
+
+/*!
+ * FindNewline() - Return the first newline at or after p, or nullptr if
+ * the text ends first.
+ */
+FCAL_NO_SANITIZE_MEMORY
+static const char *FindNewline(const char *p) {
+#ifdef __SSE2__
+  const char *block;
+  int skip;
+  __m128i chunk = LoadBlock(p, &block, &skip);
+  int valid = 0xFFFF & ~((1 << skip) - 1);
+  for (;;) {
+    int newline = MatchMask(chunk, '\n') & valid;
+    int zero = MatchMask(chunk, '\0') & valid;
+    if (newline && (!zero || LowestBit(newline) < LowestBit(zero))) {
+      return block + LowestBit(newline);
+    }
+    if (zero) return nullptr;
+    block += kVectorBytes;
+    valid = 0xFFFF;
+    chunk = _mm_load_si128(reinterpret_cast<const __m128i *>(block));
+  }
+#else
+  for (; *p != '\0'; ++p) {
+    if (*p == '\n') return p;
+  }
+  return nullptr;
+#endif
+} /* FindNewline() */
+
+/*******************************************************************************
+ * Functions
+ ******************************************************************************/
+int SkipWhitespaceAndComments(const char *text) {
+  const char *p = text;
+
+  for (;;) {
+    if (IsSpace(*p)) p = SkipSpaceRun(p);
+    if (p[0] != '/') break;
+
+    if (p[1] == '*') {
+      // The closing "*" may not be the one that opened the comment.
+      const char *end = FindBlockCommentEnd(p + 2);
+      if (end == nullptr) break;
+      p = end + 2;
+    } else if (p[1] == '/') {
+      const char *end = FindNewline(p + 2);
+      if (end == nullptr) break;
+      p = end + 1;
+    } else {
+      break;
+    }
+  } /* for() */
+
+  return static_cast<int>(p - text);
+} /* SkipWhitespaceAndComments() */
+
+} /* namespace scanner */
+} /* namespace fcal */
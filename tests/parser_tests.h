@@ -1,12 +1,24 @@
 #include <cxxtest/TestSuite.h>
 
-#include "include/ext_token.h"
+#include "include/arena.h"
+#include "include/ast_cache.h"
+#include "include/ast_serial.h"
+#include "include/ast.h"
 #include "include/parse_result.h"
 #include "include/parser.h"
+#include "include/parser_pool.h"
 #include "include/read_input.h"
 #include "include/scanner.h"
 
+#include <dirent.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fstream>
 #include <sstream>
+#include <thread>
+#include <vector>
 
 using namespace std;
 using namespace fcal::scanner;
@@ -105,4 +117,568 @@ class ParserTestSuite : public CxxTest::TestSuite {
     msg += "\n" + pr.errors();
     TSM_ASSERT(msg, pr.ok());
   }
+
+  // A streaming parser pulls tokens in small batches as it goes, and
+  // must build the same tree, or report the same error, as one that
+  // scans the whole program first.
+  void streaming_test(const char *filename) {
+    const char *text = ReadInputFromFile(filename);
+    TS_ASSERT(text);
+    Parser whole;
+    Parser streaming;
+    streaming.streaming(true);
+    ParseResult pr_whole = whole.Parse(text);
+    ParseResult pr_streaming = streaming.Parse(text);
+    string msg(filename);
+    msg += "\n" + pr_streaming.errors();
+    TSM_ASSERT_EQUALS(msg, pr_streaming.ok(), pr_whole.ok());
+    TSM_ASSERT_EQUALS(msg, pr_streaming.errors(), pr_whole.errors());
+    if (pr_whole.ok() && pr_streaming.ok()) {
+      TSM_ASSERT_EQUALS(msg, pr_streaming.ast()->unparse(),
+                        pr_whole.ast()->unparse());
+    }
+  }
+
+  void test_parse_streaming_samples() {
+    streaming_test("./samples/sample_1.dsl");
+    streaming_test("./samples/sample_5.dsl");
+    streaming_test("./samples/forest_loss_v2.dsl");
+  }
+
+  void test_parse_streaming_bad_syntax() {
+    streaming_test("./samples/bad_syntax_good_tokens.dsl");
+  }
+
+  // A parser can work straight from an open input file.
+  void test_parse_input_buffer() {
+    InputBuffer input;
+    TS_ASSERT(input.Open("./samples/sample_5.dsl"));
+    Parser parser;
+    ParseResult pr = parser.Parse(input);
+    TSM_ASSERT(pr.errors(), pr.ok());
+  }
+
+  // A program piped in parses, streaming or not, as it does from its
+  // file.
+  void test_parse_from_pipe() {
+    const char *text = ReadInputFromFile("./samples/forest_loss_v2.dsl");
+    TS_ASSERT(text);
+    if (text == NULL) return;
+    int fds[2];
+    TS_ASSERT_EQUALS(pipe(fds), 0);
+    // The sample fits in the pipe's buffer, so it can be written first.
+    size_t length = strlen(text);
+    TS_ASSERT_EQUALS(write(fds[1], text, length), (ssize_t) length);
+    close(fds[1]);
+    InputBuffer input;
+    TS_ASSERT(input.Open(fds[0]));
+    close(fds[0]);
+    Parser whole;
+    Parser streaming;
+    streaming.streaming(true);
+    ParseResult pr_file = whole.Parse(text);
+    ParseResult pr_pipe = streaming.Parse(input);
+    TSM_ASSERT(pr_pipe.errors(), pr_pipe.ok());
+    if (pr_file.ok() && pr_pipe.ok()) {
+      TS_ASSERT_EQUALS(pr_pipe.ast()->unparse(), pr_file.ast()->unparse());
+    }
+  }
+
+  // Syntax errors say where the offending token is.
+  void test_parse_error_location() {
+    Parser p;
+    ParseResult pr = p.Parse("main () {\n  int x ;\n  x = 1\n}\n");
+    TS_ASSERT(!pr.ok());
+    TS_ASSERT_EQUALS(pr.errors().find("line 4, column 1: "), 0u);
+  }
+
+  // A syntax error deep inside a program stops the parse with the
+  // first error, and the parser is ready for the next program.
+  void test_parse_first_error_only() {
+    Parser p;
+    ParseResult pr = p.Parse("main () { if (x > 1) { y = (1 + 2 ; } }");
+    TS_ASSERT(!pr.ok());
+    TS_ASSERT(pr.ast() == NULL);
+    TS_ASSERT_DIFFERS(pr.errors().find("Expected ) but found ;"),
+                      std::string::npos);
+
+    pr = p.Parse("main () { x = 1 ; ) }");
+    TS_ASSERT(!pr.ok());
+    TS_ASSERT_DIFFERS(
+        pr.errors().find("Unexpected symbol ) while parsing a statement"),
+        std::string::npos);
+
+    pr = p.Parse("main () { x = 1 ; }");
+    TS_ASSERT(pr.ok());
+  }
+
+  // A token that binds but has no led, such as '(' after an operand,
+  // is a syntax error rather than a token parse_expr cannot get past.
+  void test_parse_operand_then_paren() {
+    Parser p;
+    ParseResult pr = p.Parse("main () { x = 1 ( 2 ) ; }");
+    TS_ASSERT(!pr.ok());
+    TS_ASSERT_DIFFERS(pr.errors().find("while parsing an expression"),
+                      std::string::npos);
+  }
+
+  // Binding powers from the token table group the operands.
+  void test_parse_expr_precedence() {
+    Parser p;
+    ParseResult pr = p.Parse("main () { x = 1 + 2 * 3 - 4 / 2 > 1 + 1 ; }");
+    TS_ASSERT(pr.ok());
+    if (!pr.ok()) return;
+    TS_ASSERT_EQUALS(pr.ast()->unparse(),
+                     "main () {\nx = 1 + 2 * 3 - 4 / 2 > 1 + 1;\n\n}\n");
+  }
+
+  // Operators of the same precedence associate to the left, and those
+  // that bind tighter make the right operand.
+  void test_parse_expr_left_associative() {
+    Parser p;
+    ParseResult pr = p.Parse("main () { x = 1 - 2 - 3 * 4 ; }");
+    TS_ASSERT(pr.ok());
+    if (!pr.ok()) return;
+    using namespace fcal::ast;
+    Root *root = static_cast<Root *>(pr.ast());
+    StmtsBlock *stmts = static_cast<StmtsBlock *>(root->stmts());
+    AssignStmt *assign = static_cast<AssignStmt *>(stmts->stmt(0));
+
+    // ((1 - 2) - (3 * 4))
+    BinOpExpr *outer = assign->expr()->AsBinOp();
+    TS_ASSERT(outer);
+    if (!outer) return;
+    TS_ASSERT_EQUALS(std::string(outer->op()), "-");
+    TS_ASSERT(outer->left()->AsBinOp());
+    TS_ASSERT_EQUALS(outer->left()->unparse(), "1 - 2");
+    TS_ASSERT(outer->right()->AsBinOp());
+    TS_ASSERT_EQUALS(outer->right()->unparse(), "3 * 4");
+  }
+
+  // Long operator chains are parsed and emitted with loops, so they do
+  // not run out of stack.
+  void test_parse_long_expression() {
+    std::string text = "main () { x = 1";
+    for (int i = 0; i < 300000; i++) text += " + 1 * 2";
+    text += " ; }";
+    Parser p;
+    ParseResult pr = p.Parse(text.c_str());
+    TSM_ASSERT(pr.errors(), pr.ok());
+    if (!pr.ok()) return;
+    std::string unparsed = pr.ast()->unparse();
+    TS_ASSERT_EQUALS(unparsed.size(),
+                     strlen("main () {\nx = 1;\n\n}\n") + 300000 * 8);
+  }
+
+  // Statement lists are parsed and emitted with a loop, so a very
+  // long program does not run out of stack.
+  void test_parse_long_statement_list() {
+    std::string text = "main () {\n";
+    for (int i = 0; i < 300000; i++) text += "x = x + 1 ;\n";
+    text += "{ y = 2 ; } }\n";
+    Parser p;
+    ParseResult pr = p.Parse(text.c_str());
+    TSM_ASSERT(pr.errors(), pr.ok());
+    if (!pr.ok()) return;
+    std::string code = pr.ast()->CppCode();
+    TS_ASSERT_EQUALS(code.size() - code.rfind("x = x + 1;"),
+                     strlen("x = x + 1;\n{\ny = 2;\n}\n\n}\n"));
+  }
+
+  // A parser can be used for one program after another.
+  void test_parse_twice_with_one_parser() {
+    Parser p;
+    const char *text = "main () { x = (1 + 2) * 3 ; y = x > 4 ; }";
+    ParseResult first = p.Parse(text);
+    ParseResult second = p.Parse(text);
+    TS_ASSERT(first.ok());
+    TS_ASSERT(second.ok());
+    TS_ASSERT_EQUALS(first.ast()->unparse(), second.ast()->unparse());
+    TS_ASSERT_DIFFERS(first.ast(), second.ast());
+  }
+
+  // Allocations are aligned, strings are copied, and memory is reused
+  // after a reset.
+  void test_arena() {
+    Arena arena;
+    char *first = static_cast<char *>(arena.Allocate(3));
+    char *second = static_cast<char *>(arena.Allocate(1));
+    TS_ASSERT_EQUALS(reinterpret_cast<uintptr_t>(first) % 16, 0u);
+    TS_ASSERT_EQUALS(reinterpret_cast<uintptr_t>(second) % 16, 0u);
+    TS_ASSERT_DIFFERS(first, second);
+
+    const char *text = "print \"hello\" ;";
+    const char *copy = arena.CopyString(text + 6, 7);
+    TS_ASSERT_EQUALS(std::string(copy), "\"hello\"");
+
+    // Larger than any block is made on its own.
+    char *big = static_cast<char *>(arena.Allocate(4 * 1024 * 1024));
+    memset(big, 1, 4 * 1024 * 1024);
+
+    arena.Reset();
+    TS_ASSERT_EQUALS(static_cast<char *>(arena.Allocate(3)), first);
+  }
+
+  // The tree lives in the arena of the result, not the parser, so it
+  // can still be used after the parser is gone.
+  void test_parse_tree_outlives_parser() {
+    ParseResult pr;
+    {
+      Parser p;
+      pr = p.Parse("main () { int x ; x = 3 + 4 ; print (\"x\") ; }");
+    }
+    TS_ASSERT(pr.ok());
+    TS_ASSERT(pr.arena());
+    TS_ASSERT_EQUALS(pr.ast()->unparse(),
+                     "main () {\nint x;\nx = 3 + 4;\nprint(\"x\");\n\n}\n");
+  }
+
+  // Each production builds its node from the typed nodes of the ones
+  // it calls, through declarations, nested blocks and expressions.
+  void test_parse_typed_productions() {
+    Parser p;
+    ParseResult pr = p.Parse(
+        "main () { matrix m [ 2 : 3 ] i : j = i * j ; "
+        "{ if ( m [ 0 : 1 ] > 2 ) print ( let int y ; in y end ) ; } }");
+    TS_ASSERT(pr.ok());
+    TS_ASSERT_EQUALS(pr.ast()->unparse(),
+                     "main () {\nmatrix m [2: 3] i: j = i * j;\n"
+                     "{\nif (m [0: 1] > 2) print(let int y;\n in y end);\n"
+                     "}\n\n}\n");
+  }
+
+  // Once the result of a parse is dropped, the next parse reuses its
+  // arena and symbol table instead of making new ones.
+  void test_parser_reset_reuses_arena() {
+    Parser parser;
+    Arena *arena;
+    {
+      ParseResult pr = parser.Parse("main () { int x ; x = 1 ; }");
+      TS_ASSERT(pr.ok());
+      arena = pr.arena().get();
+    }
+    ParseResult pr = parser.Parse("main () { int y ; y = 2 ; }");
+    TS_ASSERT(pr.ok());
+    TS_ASSERT_EQUALS(pr.arena().get(), arena);
+    TS_ASSERT_EQUALS(pr.symbols()->size(), 2);
+    TS_ASSERT_EQUALS(pr.ast()->unparse(),
+                     "main () {\nint y;\ny = 2;\n\n}\n");
+  }
+
+  // Threads check parsers out of a pool and give them back for the
+  // next thread.
+  void test_parser_pool() {
+    ParserPool pool(2);
+    std::vector<std::string> unparsed(8);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; t++) {
+      threads.push_back(std::thread([&pool, &unparsed, t]() {
+        std::string text = "main () { x = " + std::to_string(t) + " ; }";
+        ParserPool::Lease parser = pool.Acquire();
+        ParseResult pr = parser->Parse(text.c_str());
+        if (pr.ok()) unparsed[t] = pr.ast()->unparse();
+      }));
+    }
+    for (size_t t = 0; t < threads.size(); t++) threads[t].join();
+
+    for (int t = 0; t < 8; t++) {
+      TS_ASSERT_EQUALS(unparsed[t], "main () {\nx = " + std::to_string(t) +
+                                    ";\n\n}\n");
+    }
+    TS_ASSERT(pool.idle() >= 1);
+    TS_ASSERT(pool.idle() <= 2);
+
+    Parser *first;
+    {
+      ParserPool::Lease parser = pool.Acquire();
+      first = parser.get();
+    }
+    ParserPool::Lease parser = pool.Acquire();
+    TS_ASSERT_EQUALS(parser.get(), first);
+  }
+
+  // A tree saved in the cache is loaded back without parsing, the same
+  // as the tree it was saved from, and a damaged entry is a miss.
+  void test_ast_cache() {
+    char dir[] = "/tmp/fcal_ast_cache_XXXXXX";
+    TS_ASSERT(mkdtemp(dir));
+    const char *text =
+        "main () { int n ; float f ; string s ; boolean b ; "
+        "matrix m [ 2 : 3 ] i : j = i * j ; matrix k = m ; "
+        "m [ 0 : 1 ] = 2.5 ; n = m [ 1 : 2 ] + n ( 1 ) ; "
+        "s = \"hi\" ; b = ! True ; b = False ; "
+        "if ( n < 2 ) { print ( n ) ; } else ; "
+        "if ( b ) print ( ( 1 + 2 ) * 3 - 4 ) ; "
+        "repeat ( n = 1 to 10 ) f = if b then 1 else 2 ; "
+        "while ( n >= 0 ) n = let int t ; t = n ; in t - 1 end ; }";
+
+    Parser p;
+    AstCache cache(dir);
+    ParseResult missed;
+    TS_ASSERT(!cache.Load(text, &missed));
+
+    ParseResult parsed = cache.Parse(&p, text);
+    TSM_ASSERT(parsed.errors(), parsed.ok());
+    if (!parsed.ok()) return;
+
+    ParseResult loaded;
+    TS_ASSERT(cache.Load(text, &loaded));
+    TS_ASSERT(loaded.ok());
+    TS_ASSERT_DIFFERS(loaded.arena(), parsed.arena());
+    TS_ASSERT_EQUALS(loaded.ast()->unparse(), parsed.ast()->unparse());
+    TS_ASSERT_EQUALS(loaded.ast()->CppCode(), parsed.ast()->CppCode());
+
+    // Cut the entry short.
+    std::string command = std::string("for f in ") + dir +
+                          "/*.ast; do truncate -s -3 $f; done";
+    TS_ASSERT_EQUALS(system(command.c_str()), 0);
+    TS_ASSERT(!cache.Load(text, &missed));
+    ParseResult reparsed = cache.Parse(&p, text);
+    TS_ASSERT(reparsed.ok());
+    TS_ASSERT(cache.Load(text, &loaded));
+
+    command = std::string("rm -rf ") + dir;
+    TS_ASSERT_EQUALS(system(command.c_str()), 0);
+  }
+
+  // The names of the entries in a cache directory.
+  static std::vector<std::string> cache_entries(const char *dir) {
+    std::vector<std::string> names;
+    DIR *d = opendir(dir);
+    if (d == NULL) return names;
+    while (struct dirent *entry = readdir(d)) {
+      if (strstr(entry->d_name, ".ast")) names.push_back(entry->d_name);
+    }
+    closedir(d);
+    return names;
+  }
+
+  // An entry is only used for the text saved in it, not for another
+  // text of the same size whose hash is the same.
+  void test_ast_cache_same_hash() {
+    char dir[] = "/tmp/fcal_ast_cache_XXXXXX";
+    TS_ASSERT(mkdtemp(dir));
+    const char *text_a = "main () { x = 1 ; }";
+    const char *text_b = "main () { y = 2 ; }";
+
+    Parser p;
+    AstCache cache(dir);
+    TS_ASSERT(cache.Parse(&p, text_a).ok());
+    std::vector<std::string> names = cache_entries(dir);
+    TS_ASSERT_EQUALS(names.size(), 1u);
+    TS_ASSERT(cache.Parse(&p, text_b).ok());
+    std::vector<std::string> both = cache_entries(dir);
+    TS_ASSERT_EQUALS(both.size(), 2u);
+    if (names.size() != 1 || both.size() != 2) return;
+    std::string name_a = names[0];
+    std::string name_b = both[0] == name_a ? both[1] : both[0];
+
+    // Make the entry of text_b a copy of that of text_a, as it would
+    // be if the two hashes were the same.
+    uint64_t hash_a = strtoull(name_a.c_str(), NULL, 16);
+    uint64_t hash_b = strtoull(name_b.c_str(), NULL, 16);
+    std::ifstream in(std::string(dir) + "/" + name_a, std::ios::binary);
+    std::string entry((std::istreambuf_iterator<char>(in)),
+                      std::istreambuf_iterator<char>());
+    size_t at = entry.find(std::string(
+        reinterpret_cast<const char *>(&hash_a), sizeof(hash_a)));
+    TS_ASSERT_DIFFERS(at, std::string::npos);
+    if (at == std::string::npos) return;
+    entry.replace(at, sizeof(hash_b),
+                  reinterpret_cast<const char *>(&hash_b), sizeof(hash_b));
+    std::ofstream out(std::string(dir) + "/" + name_b, std::ios::binary);
+    out << entry;
+    out.close();
+
+    ParseResult loaded;
+    TS_ASSERT(!cache.Load(text_b, &loaded));
+    ParseResult parsed = cache.Parse(&p, text_b);
+    TS_ASSERT(parsed.ok());
+    if (parsed.ok()) {
+      TS_ASSERT_DIFFERS(parsed.ast()->unparse().find("y = 2"),
+                        std::string::npos);
+    }
+    TS_ASSERT(cache.Load(text_a, &loaded));
+
+    std::string command = std::string("rm -rf ") + dir;
+    TS_ASSERT_EQUALS(system(command.c_str()), 0);
+  }
+
+  // Only the tree of a whole program is loaded, though any part of
+  // one can be saved.
+  void test_load_tree_only_roots() {
+    using namespace fcal::ast;
+    Parser p;
+    ParseResult pr = p.Parse("main () { x = 1 ; }");
+    TS_ASSERT(pr.ok());
+    if (!pr.ok()) return;
+    Root *root = static_cast<Root *>(pr.ast());
+    Stmt *stmt = static_cast<StmtsBlock *>(root->stmts())->stmt(0);
+
+    Arena arena;
+    AstWriter whole;
+    whole.Save(root);
+    TS_ASSERT(LoadTree(whole.bytes().data(), whole.bytes().size(), &arena,
+                       pr.symbols().get()));
+    AstWriter part;
+    part.Save(stmt);
+    TS_ASSERT(LoadTree(part.bytes().data(), part.bytes().size(), &arena,
+                       pr.symbols().get()) == NULL);
+  }
+
+  // Reparse parses the statement an edit touches again and reuses the
+  // others, in the program and in nested blocks.
+  void test_reparse_reuses_statements() {
+    using namespace fcal::ast;
+    std::string text = "main () {\n  int x ;\n  x = 1 ;\n"
+                       "  { y = 2 ; z = 3 ; }\n  print ( x ) ;\n}\n";
+    Parser p;
+    ParseResult before = p.Parse(text.c_str());
+    TS_ASSERT(before.ok());
+    if (!before.ok()) return;
+    StmtsBlock *old_block =
+        static_cast<StmtsBlock *>(static_cast<Root *>(before.ast())->stmts());
+
+    // x = 1 ; becomes x = 42 ;
+    size_t at = text.find("1 ;");
+    std::string edited = text.substr(0, at) + "42" + text.substr(at + 1);
+    ParseResult after = p.Reparse(before, edited.c_str(), at, 1, 2);
+    TS_ASSERT(after.ok());
+    TS_ASSERT_EQUALS(after.ast()->unparse(),
+                     p.Parse(edited.c_str()).ast()->unparse());
+    StmtsBlock *block =
+        static_cast<StmtsBlock *>(static_cast<Root *>(after.ast())->stmts());
+    TS_ASSERT_EQUALS(block->count(), 4);
+    TS_ASSERT_EQUALS(block->stmt(0), old_block->stmt(0));
+    TS_ASSERT_DIFFERS(block->stmt(1), old_block->stmt(1));
+    TS_ASSERT_EQUALS(block->stmt(2), old_block->stmt(2));
+    TS_ASSERT_EQUALS(block->stmt(3), old_block->stmt(3));
+
+    // z = 3 ; in the nested block becomes z = 3 + w ;
+    at = edited.find("3 ;") + 1;
+    std::string nested = edited.substr(0, at) + " + w" + edited.substr(at);
+    ParseResult again = p.Reparse(after, nested.c_str(), at, 0, 4);
+    TS_ASSERT(again.ok());
+    TS_ASSERT_EQUALS(again.ast()->unparse(),
+                     p.Parse(nested.c_str()).ast()->unparse());
+    StmtsBlock *outer =
+        static_cast<StmtsBlock *>(static_cast<Root *>(again.ast())->stmts());
+    TS_ASSERT_EQUALS(outer->stmt(1), block->stmt(1));
+    TS_ASSERT_EQUALS(outer->stmt(3), block->stmt(3));
+    StmtsStmt *old_nested = block->stmt(2)->AsStmtsStmt();
+    StmtsStmt *new_nested = outer->stmt(2)->AsStmtsStmt();
+    TS_ASSERT(old_nested);
+    TS_ASSERT(new_nested);
+    if (!old_nested || !new_nested) return;
+    StmtsBlock *old_inner = static_cast<StmtsBlock *>(old_nested->stmts());
+    StmtsBlock *new_inner = static_cast<StmtsBlock *>(new_nested->stmts());
+    TS_ASSERT_EQUALS(new_inner->stmt(0), old_inner->stmt(0));
+    TS_ASSERT_DIFFERS(new_inner->stmt(1), old_inner->stmt(1));
+  }
+
+  // A long run of edits does not grow the arena without bound: once it
+  // holds kMaxReparseGrowth times the tree, the text is parsed whole
+  // into a new arena.
+  void test_reparse_bounds_arena() {
+    std::string text = "main () {\n  x = 1 ;\n  y = 2 ;\n}\n";
+    int at = static_cast<int>(text.find("x = ")) + 4;
+    Parser p;
+    ParseResult pr = p.Parse(text.c_str());
+    std::shared_ptr<Arena> first = pr.arena();
+    bool renewed = false;
+    for (int i = 0; i < 1000; i++) {
+      text[at] = text[at] == '1' ? '2' : '1';
+      pr = p.Reparse(pr, text.c_str(), at, 1, 1);
+      TS_ASSERT(pr.ok());
+      TS_ASSERT_LESS_THAN_EQUALS(
+          pr.arena()->used(),
+          (Parser::kMaxReparseGrowth + 1) * pr.tree_bytes());
+      if (pr.arena() != first) renewed = true;
+    }
+    TS_ASSERT(renewed);
+  }
+
+  // The saved form of a tree, with the names of its variables in place
+  // of their symbols, so that trees parsed with different symbol tables
+  // can be compared. Unlike unparse, it also works for trees with
+  // missing operands, such as that of x = ;
+  static std::string saved_tree(const ParseResult &pr) {
+    using namespace fcal::ast;
+    AstWriter out;
+    out.Save(pr.ast());
+    const std::string &bytes = out.bytes();
+    size_t i = 0;
+    auto read_int = [&bytes, &i]() {
+      int value;
+      memcpy(&value, bytes.data() + i, sizeof(value));
+      i += sizeof(value);
+      return value;
+    };
+
+    std::ostringstream shape;
+    while (i < bytes.size()) {
+      int kind = bytes[i++];
+      shape << kind << ' ';
+      if (kind == kRootNode) {
+        shape << read_int();
+      } else if (kind == kStmtsBlockNode) {
+        int count = read_int();
+        for (int k = 0; k <= count; k++) shape << read_int() << ' ';
+      } else if (kind == kSimpleDeclNode || kind == kBinOpExprNode) {
+        shape << static_cast<int>(bytes[i++]);
+      } else if (kind == kVarNameNode) {
+        shape << pr.symbols()->name(read_int());
+      } else if (kind == kAnyConstNode) {
+        int length = read_int();
+        shape << bytes.substr(i, length);
+        i += length;
+      }
+      shape << '\n';
+    }
+    return shape.str();
+  }
+
+  // After any edit, Reparse gives the result of parsing the whole text,
+  // including when it has to fall back to that.
+  void test_reparse_matches_parse() {
+    const char *pieces[] = {" ", ";", "x", "1", "+", "{", "}", "=", "\n",
+                            "( ", ")", "print ", "if ", "int ", "/*", "*/",
+                            "\"", "y = 2 ; "};
+    const int num_pieces = sizeof(pieces) / sizeof(pieces[0]);
+    std::string text = "main () {\n  int x ;\n  x = 1 ;\n"
+                       "  { y = 2 ; { z = 3 ; } }\n"
+                       "  if ( x > 1 ) { print ( x ) ; } else ;\n"
+                       "  while ( x ) { x = x - 1 ; }\n}\n";
+    Parser p;
+    Parser full;
+    ParseResult pr = p.Parse(text.c_str());
+    unsigned seed = 12345;
+    for (int round = 0; round < 2000; round++) {
+      seed = seed * 1103515245u + 12345u;
+      int begin = (seed >> 8) % (text.size() + 1);
+      seed = seed * 1103515245u + 12345u;
+      int old_length = (seed >> 8) % 3;
+      if (begin + old_length > static_cast<int>(text.size())) old_length = 0;
+      seed = seed * 1103515245u + 12345u;
+      std::string piece = (seed >> 8) % 4 == 0 ? "" :
+                          pieces[(seed >> 12) % num_pieces];
+
+      std::string edited = text.substr(0, begin) + piece +
+                           text.substr(begin + old_length);
+      ParseResult next = p.Reparse(pr, edited.c_str(), begin, old_length,
+                                   piece.size());
+      ParseResult expected = full.Parse(edited.c_str());
+      TS_ASSERT_EQUALS(next.ok(), expected.ok());
+      TS_ASSERT_EQUALS(next.errors(), expected.errors());
+      if (next.ok() && expected.ok()) {
+        TS_ASSERT_EQUALS(saved_tree(next), saved_tree(expected));
+      }
+      // Edits that break the program are undone, so that it keeps
+      // something to reparse.
+      if (next.ok() || !pr.ok()) {
+        text = edited;
+        pr = next;
+      }
+    }
+  }
 };
@@ -1,7 +1,18 @@
 #include <cxxtest/TestSuite.h>
 
+#include <ctype.h>
+#include <pthread.h>
+#include <signal.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <thread>
 #include "include/read_input.h"
+#include "include/lexer.h"
+#include "include/prefetch_reader.h"
+#include "include/line_index.h"
+#include "include/whitespace.h"
 #include "include/scanner.h"
 #include "include/regex.h"
 
@@ -194,6 +205,113 @@ public:
       make_token_test(scanner::kLexicalError, "b", 1);
     }
 
+    // Every scanner reads the same compiled regular expressions rather
+    // than compiling its own.
+    void test_regex_tables_are_shared() {
+      scanner::Scanner other;
+      for (int i = scanner::kIntKwd; i < scanner::kLexicalError+1; i++) {
+        TS_ASSERT(s->get_regex(i) != NULL);
+        TS_ASSERT_EQUALS(s->get_regex(i), other.get_regex(i));
+      }
+    }
+
+    /* The single-pass lexer in MatchToken must pick the same terminal
+       and length as the longest match over all of the regular
+       expressions above, earliest terminal winning ties.
+    */
+    void match_token_test (const char * text) {
+      int max_matched = 0;
+      int regex_terminal = scanner::kLexicalError;
+      for (int i = scanner::kIntKwd; i < scanner::kLexicalError+1; i++) {
+        int matched = scanner::match_regex(s->get_regex(i), text);
+        if (max_matched < matched) {
+          max_matched = matched;
+          regex_terminal = i;
+        }
+      }
+      scanner::TokenType terminal;
+      int length = scanner::MatchToken(text, &terminal);
+      TSM_ASSERT_EQUALS(text, length, max_matched);
+      TSM_ASSERT_EQUALS(text, terminal, regex_terminal);
+    }
+
+    void test_match_token_keywords_and_names() {
+      const char *cases[] = { "int", "integer", "in", "inx", "if(", "True",
+                              "Truex", "end_", "to2", "EOF", "_", "while ",
+                              "repeat;" };
+      for (unsigned i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        match_token_test(cases[i]);
+      }
+    }
+
+    // Every keyword in the token table is found by the keyword hash,
+    // and names one character longer or shorter lex as the regexes do.
+    void test_keyword_type_from_token_specs() {
+      for (int t = 0; t < scanner::kNumTerminals; t++) {
+        const char *spelling = scanner::kTokenSpecs[t].spelling;
+        if (spelling == NULL || !isalpha(spelling[0])) continue;
+        int length = strlen(spelling);
+        TS_ASSERT_EQUALS(scanner::KeywordType(spelling, length), t);
+        std::string longer = std::string(spelling) + "x";
+        TS_ASSERT_EQUALS(scanner::KeywordType(longer.c_str(), length + 1),
+                         scanner::kVariableName);
+        std::string shorter(spelling, length - 1);
+        match_token_test(spelling);
+        match_token_test(longer.c_str());
+        if (length > 1) match_token_test(shorter.c_str());
+      }
+    }
+
+    void test_match_token_numbers() {
+      const char *cases[] = { "0", "145 ", "14.358", "12.", ".5", ".",
+                              "1.2.3", "7x" };
+      for (unsigned i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        match_token_test(cases[i]);
+      }
+    }
+
+    void test_match_token_strings_and_operators() {
+      const char *cases[] = { "\"a\" \"b\"", "\"two\nlines\"", "\"open",
+                              "<=", "<", ">=", ">", "==", "=", "!=", "!",
+                              "&&", "&", "||", "|", "$", "/" };
+      for (unsigned i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        match_token_test(cases[i]);
+      }
+    }
+
+    /* SkipWhitespaceAndComments must skip exactly as much as the
+       regular expressions do, including the cases they refuse.  The
+       long cases cross several 16 byte blocks and are started at every
+       offset so that each alignment is tried.
+    */
+    void skip_test (const char * text) {
+      int len = strlen(text);
+      for (int i = 0; i <= len; i++) {
+        TSM_ASSERT_EQUALS(text + i, scanner::SkipWhitespaceAndComments(text + i),
+                          scanner::consume_whitespace_and_comments(text + i));
+      }
+    }
+
+    void test_skip_whitespace() {
+      const char *cases[] = { "", "x", " \t\r\n x", "                    "
+                              "                  end", "\n\n\n" };
+      for (unsigned i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        skip_test(cases[i]);
+      }
+    }
+
+    void test_skip_comments() {
+      const char *cases[] = { "/**/x", "/*/ x", "/* a **/ b", "/* a * / b",
+                              "/* open", "/* a \\ b */ c", "// line\n x",
+                              "// no newline", "/* one */ /* two */\n// three\nx",
+                              "/ x", "/*  a comment longer than one block "
+                              "with a star at the end *", "/*  a comment longer "
+                              "than one block ending right here */ x" };
+      for (unsigned i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        skip_test(cases[i]);
+      }
+    }
+
     /* You must have at least one separate test case for each terminal
        symbol.  Thus, you need a test that will pass or fail based
        solely on the regular expression (and its corresponding code)
@@ -360,6 +478,345 @@ public:
         scanFileNoLexicalErrors("./samples/forest_loss_v2.dsl");
     }
 
+    // The contiguous token stream holds the same tokens as the list,
+    // with offsets into the scanned text.
+    void test_scan_stream() {
+        const char *text = " 123 x /* c */ 12.34 ";
+        scanner::TokenStream stream;
+        s->Scan(text, &stream);
+        TS_ASSERT_EQUALS(stream.size(), 4);
+        scanner::TokenType ts[] = { scanner::kIntConst, scanner::kVariableName,
+                                    scanner::kFloatConst, scanner::kEndOfFile };
+        int offsets[] = { 1, 5, 15, 21 };
+        scanner::Token *tks = s->Scan(text);
+        for (int i = 0; i < stream.size() && tks != NULL; i++) {
+            TS_ASSERT_EQUALS(stream.terminal(i), ts[i]);
+            TS_ASSERT_EQUALS(stream.offset(i), offsets[i]);
+            TS_ASSERT_EQUALS(stream.lexeme(i), tks->lexeme());
+            tks = tks->next();
+        }
+        TS_ASSERT(tks == NULL);
+    }
+
+    // Small files are read into a buffer holding the same text as
+    // ReadInputFromFile gives.
+    void test_input_buffer_samples() {
+        const char *files[] = { "./samples/sample_1.dsl",
+                                "./samples/forest_loss_v2.dsl",
+                                "./samples/bad_syntax_good_tokens.dsl" };
+        for (unsigned i = 0; i < sizeof(files) / sizeof(files[0]); i++) {
+            scanner::InputBuffer input;
+            TS_ASSERT(input.Open(files[i]));
+            const char *text = scanner::ReadInputFromFile(files[i]);
+            TS_ASSERT(text);
+            if (text && input.text()) {
+                TS_ASSERT_EQUALS(input.size(), strlen(text));
+                TS_ASSERT_EQUALS(strcmp(input.text(), text), 0);
+            }
+        }
+        scanner::InputBuffer missing;
+        TS_ASSERT(!missing.Open("./samples/no_such_file.dsl"));
+        TS_ASSERT(missing.text() == NULL);
+    }
+
+    // A large file is mapped, and is null terminated even when it ends
+    // exactly on a page boundary.
+    void test_input_buffer_maps_large_files() {
+        char filename[] = "/tmp/fcal_input_XXXXXX";
+        int fd = mkstemp(filename);
+        TS_ASSERT(fd >= 0);
+        if (fd < 0) return;
+        const char line[] = "x = 1 ;\n";
+        const int lines = 8192;  // 64KB, a whole number of pages
+        for (int i = 0; i < lines; i++) {
+            TS_ASSERT_EQUALS(write(fd, line, 8), 8);
+        }
+        close(fd);
+
+        scanner::InputBuffer input;
+        TS_ASSERT(input.Open(filename));
+        unlink(filename);
+        TS_ASSERT(input.mapped());
+        TS_ASSERT_EQUALS(input.size(), 8u * lines);
+        if (input.text() == NULL) return;
+        TS_ASSERT_EQUALS(input.text()[input.size()], '\0');
+        scanner::TokenStream stream;
+        s->Scan(input.text(), &stream);
+        TS_ASSERT_EQUALS(stream.size(), 4 * lines + 1);
+        input.Close();
+        TS_ASSERT(input.text() == NULL);
+    }
+
+    // A pipe is read to its end, however many times its buffer fills.
+    void test_input_buffer_reads_pipes() {
+        int fds[2];
+        TS_ASSERT_EQUALS(pipe(fds), 0);
+        const int lines = 128 * 1024;  // 1MB, many pipe buffers
+        std::thread writer([fds, lines]() {
+            for (int i = 0; i < lines; i++) {
+                if (write(fds[1], "x = 1 ;\n", 8) != 8) break;
+            }
+            close(fds[1]);
+        });
+        scanner::InputBuffer input;
+        TS_ASSERT(input.Open(fds[0]));
+        writer.join();
+        close(fds[0]);
+        TS_ASSERT(!input.mapped());
+        TS_ASSERT_EQUALS(input.size(), 8u * lines);
+        if (input.text() == NULL) return;
+        TS_ASSERT_EQUALS(strlen(input.text()), input.size());
+        scanner::TokenStream stream;
+        s->Scan(input.text(), &stream);
+        TS_ASSERT_EQUALS(stream.size(), 4 * lines + 1);
+    }
+
+    static void ignore_signal(int) {}
+
+    // A read interrupted by a signal is tried again rather than failing.
+    // The handler is installed without SA_RESTART, so read returns EINTR.
+    void test_input_buffer_reads_after_signal() {
+        struct sigaction action, old_action;
+        memset(&action, 0, sizeof(action));
+        action.sa_handler = ignore_signal;
+        sigemptyset(&action.sa_mask);
+        TS_ASSERT_EQUALS(sigaction(SIGUSR1, &action, &old_action), 0);
+
+        int fds[2];
+        TS_ASSERT_EQUALS(pipe(fds), 0);
+        pthread_t reader = pthread_self();
+        std::thread writer([fds, reader]() {
+            // Give the reader time to block in read first.
+            usleep(100 * 1000);
+            pthread_kill(reader, SIGUSR1);
+            usleep(50 * 1000);
+            // A short write shows up as the wrong size below.
+            ssize_t written = write(fds[1], "x = 1 ;\n", 8);
+            (void) written;
+            close(fds[1]);
+        });
+        scanner::InputBuffer input;
+        TS_ASSERT(input.Open(fds[0]));
+        writer.join();
+        close(fds[0]);
+        sigaction(SIGUSR1, &old_action, NULL);
+        TS_ASSERT_EQUALS(input.size(), 8u);
+    }
+
+    // Every file is handed out once, with its text, whatever the
+    // limit on bytes in flight, and a missing file is handed out empty.
+    void test_prefetch_reader() {
+        std::vector<std::string> paths;
+        for (int i = 0; i < 4; i++) {
+            paths.push_back("./samples/sample_1.dsl");
+            paths.push_back("./samples/forest_loss_v2.dsl");
+            paths.push_back("./samples/bad_syntax_good_tokens.dsl");
+        }
+        paths.push_back("./samples/no_such_file.dsl");
+        size_t limits[] = { 1, 1024, 1 << 20 };
+        for (int l = 0; l < 3; l++) {
+            scanner::PrefetchReader reader(paths, 3, limits[l]);
+            std::vector<int> seen(paths.size(), 0);
+            int index;
+            std::unique_ptr<scanner::InputBuffer> input;
+            while (reader.Next(&index, &input)) {
+                TS_ASSERT(index >= 0 && index < (int) paths.size());
+                seen[index]++;
+                const char *text =
+                    scanner::ReadInputFromFile(paths[index].c_str());
+                if (text == NULL) {
+                    TS_ASSERT(input->text() == NULL);
+                } else if (input->text() != NULL) {
+                    TS_ASSERT_EQUALS(strcmp(input->text(), text), 0);
+                }
+            }
+            for (size_t i = 0; i < paths.size(); i++) {
+                TS_ASSERT_EQUALS(seen[i], 1);
+            }
+        }
+    }
+
+    // Offsets map to 1 based lines and columns; a newline belongs to
+    // the line it ends.
+    void test_line_index() {
+        const char *text = "ab\n\ncd\te\n";
+        scanner::LineIndex lines;
+        lines.Reset(text);
+        int offsets[] = { 0, 1, 2, 3, 4, 7, 8, 9 };
+        int expected_lines[] = { 1, 1, 1, 2, 3, 3, 3, 4 };
+        int expected_columns[] = { 1, 2, 3, 1, 1, 4, 5, 1 };
+        for (int i = 0; i < 8; i++) {
+            int line = 0;
+            int column = 0;
+            lines.Locate(offsets[i], &line, &column);
+            TS_ASSERT_EQUALS(line, expected_lines[i]);
+            TS_ASSERT_EQUALS(column, expected_columns[i]);
+        }
+        int line = 0;
+        int column = 0;
+        lines.Reset("x");
+        lines.Locate(1, &line, &column);
+        TS_ASSERT_EQUALS(line, 1);
+        TS_ASSERT_EQUALS(column, 2);
+    }
+
+    // Scanning in parallel chunks must give exactly the tokens and
+    // symbols of the sequential scan, wherever the chunks are split.
+    void parallel_scan_test(const char *text) {
+        scanner::SymbolTable seq_table;
+        scanner::TokenStream seq;
+        seq.symbol_table(&seq_table);
+        s->Scan(text, &seq);
+        for (int chunks = 2; chunks <= 9; chunks++) {
+            scanner::SymbolTable par_table;
+            scanner::TokenStream par;
+            par.symbol_table(&par_table);
+            s->ScanParallel(text, &par, chunks);
+            TS_ASSERT_EQUALS(par.size(), seq.size());
+            for (int i = 0; i < seq.size() && i < par.size(); i++) {
+                TS_ASSERT_EQUALS(par.terminal(i), seq.terminal(i));
+                TS_ASSERT_EQUALS(par.offset(i), seq.offset(i));
+                TS_ASSERT_EQUALS(par.length(i), seq.length(i));
+                TS_ASSERT_EQUALS(par.symbol(i), seq.symbol(i));
+            }
+        }
+    }
+
+    void test_scan_parallel_samples() {
+        const char *files[] = { "./samples/sample_1.dsl",
+                                "./samples/sample_2.dsl",
+                                "./samples/sample_3.dsl",
+                                "./samples/sample_4.dsl",
+                                "./samples/sample_5.dsl",
+                                "./samples/mysample.dsl",
+                                "./samples/forest_loss_v2.dsl",
+                                "./samples/bad_syntax_good_tokens.dsl" };
+        for (unsigned i = 0; i < sizeof(files) / sizeof(files[0]); i++) {
+            const char *text = scanner::ReadInputFromFile(files[i]);
+            TS_ASSERT(text);
+            if (text) parallel_scan_test(text);
+        }
+    }
+
+    // Splits that fall inside string constants and block comments.
+    void test_scan_parallel_open_tokens() {
+        parallel_scan_test("x = \"one\ntwo\nthree\nfour\" ;\n"
+                           "/* a\nb\nc\nd */ y\n\"\n\nz\n/* \\\n*/\n"
+                           "// tail\n\n\n");
+    }
+
+    // Rescanning after an edit must leave the same tokens as scanning
+    // the edited text from scratch.
+    void rescan_test(const string &before, int begin, int old_length,
+                     const string &insert) {
+        string after = before.substr(0, begin) + insert +
+                       before.substr(begin + old_length);
+        scanner::TokenStream tokens;
+        s->Scan(before.c_str(), &tokens);
+        s->Rescan(after.c_str(), begin, old_length, insert.size(), &tokens);
+        scanner::TokenStream fresh;
+        s->Scan(after.c_str(), &fresh);
+        TSM_ASSERT_EQUALS(after, tokens.size(), fresh.size());
+        TSM_ASSERT_EQUALS(after, tokens.first_open(), fresh.first_open());
+        for (int i = 0; i < fresh.size() && i < tokens.size(); i++) {
+            TSM_ASSERT_EQUALS(after, tokens.terminal(i), fresh.terminal(i));
+            TSM_ASSERT_EQUALS(after, tokens.offset(i), fresh.offset(i));
+            TSM_ASSERT_EQUALS(after, tokens.length(i), fresh.length(i));
+        }
+    }
+
+    void test_rescan_tokens_merge_and_split() {
+        rescan_test("a b = 1 ;", 1, 1, "");
+        rescan_test("ab = 1 ;", 1, 0, " ");
+        rescan_test("x < = 1", 3, 1, "");
+        rescan_test("x = 12 ;", 6, 0, ".5");
+        rescan_test("x = 1 ;", 0, 0, "int ");
+        rescan_test("x = 1 ;", 7, 0, " y");
+        rescan_test("x = 1 ;", 0, 7, "");
+    }
+
+    void test_rescan_strings_and_comments() {
+        rescan_test("x = \"a b\" ; y", 4, 1, "");
+        rescan_test("x = a b\" ; y", 4, 0, "\"");
+        rescan_test("\"x y", 4, 0, "\"");
+        rescan_test("a /* b */ c", 3, 0, "\\");
+        rescan_test("a /* b \\ */ c", 7, 1, "");
+        rescan_test("a // b\n c", 6, 1, "");
+        rescan_test("a / b\n c", 3, 0, "*");
+    }
+
+    void test_rescan_sample() {
+        const char *text = scanner::ReadInputFromFile("./samples/sample_1.dsl");
+        TS_ASSERT(text);
+        if (!text) return;
+        string before(text);
+        int middle = before.size() / 2;
+        rescan_test(before, middle, 0, " x = y + 1 ;\n");
+        rescan_test(before, middle, 3, "");
+        rescan_test(before, 0, 0, "/* header */\n");
+    }
+
+    // Each distinct name gets the next dense symbol, and interning the
+    // same characters again gives the same symbol back.
+    void test_symbol_table_intern() {
+        scanner::SymbolTable table;
+        TS_ASSERT_EQUALS(table.Intern("x", 1), 0);
+        TS_ASSERT_EQUALS(table.Intern("total", 5), 1);
+        TS_ASSERT_EQUALS(table.Intern("xy", 1), 0);
+        TS_ASSERT_EQUALS(table.Intern("tot", 3), 2);
+        TS_ASSERT_EQUALS(table.size(), 3);
+        TS_ASSERT_EQUALS(table.name(1), "total");
+        char name[16];
+        for (int i = 0; i < 1000; i++) {
+            int length = sprintf(name, "v%d", i);
+            TS_ASSERT_EQUALS(table.Intern(name, length), i + 3);
+        }
+        for (int i = 999; i >= 0; i--) {
+            int length = sprintf(name, "v%d", i);
+            TS_ASSERT_EQUALS(table.Intern(name, length), i + 3);
+        }
+        TS_ASSERT_EQUALS(table.name(3), "v0");
+    }
+
+    // Scanning into a stream with a symbol table interns each variable
+    // name; keywords and other tokens get no symbol.
+    void test_scan_interns_variable_names() {
+        const char *text = "i = i + j ; int j";
+        scanner::SymbolTable table;
+        scanner::TokenStream stream;
+        stream.symbol_table(&table);
+        s->Scan(text, &stream);
+        int symbols[] = { 0, -1, 0, -1, 1, -1, -1, 1, -1 };
+        TS_ASSERT_EQUALS(stream.size(), 9);
+        for (int i = 0; i < stream.size() && i < 9; i++) {
+            TS_ASSERT_EQUALS(stream.symbol(i), symbols[i]);
+        }
+        TS_ASSERT_EQUALS(table.size(), 2);
+        TS_ASSERT_EQUALS(table.name(1), "j");
+    }
+
+    // Scanning a few tokens at a time with ScanNext gives the same
+    // stream as scanning the whole program at once.
+    void test_scan_next_in_batches() {
+        const char *text = scanner::ReadInputFromFile("./samples/sample_1.dsl");
+        TS_ASSERT(text);
+        scanner::TokenStream whole;
+        s->Scan(text, &whole);
+        scanner::TokenStream batches;
+        batches.Reset(text);
+        int offset = 0;
+        while (batches.size() == 0 ||
+               batches.terminal(batches.size() - 1) != scanner::kEndOfFile) {
+            offset = s->ScanNext(text, offset, 3, &batches);
+        }
+        TS_ASSERT_EQUALS(batches.size(), whole.size());
+        for (int i = 0; i < whole.size() && i < batches.size(); i++) {
+            TS_ASSERT_EQUALS(batches.terminal(i), whole.terminal(i));
+            TS_ASSERT_EQUALS(batches.offset(i), whole.offset(i));
+            TS_ASSERT_EQUALS(batches.length(i), whole.length(i));
+        }
+    }
+
 
 
 };